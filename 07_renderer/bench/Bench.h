@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+
+#include "Debug.h"
+
+
+/**
+ * @brief the benchmarks run with a hidden window, its context is current 
+ * when they are called. Those flagged CPU only in main.cpp also run when 
+ * no context can be created
+ */
+void BenchQuantization();
+void BenchMeshOptimizer();
+void BenchInstancing();
+void BenchRenderQueue();
+void BenchObjLoader();
+void BenchGltf();
+void BenchLod();
+void BenchMeshlets();
+void BenchStrips();
+void BenchCulling();
+void BenchBvh();
+void BenchOcclusion();
+void BenchHiZ();
+void BenchEcs();
+void BenchJobs();
+void BenchTransforms();
+void BenchMath();
+void BenchCommands();
+
+
+/**
+ * @brief wall clock in milliseconds, for the CPU side of the benchmarks
+ */
+inline double NowMilliseconds() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,87 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "Bvh.h"
+#include "FrustumCuller.h"
+
+
+static const size_t OBJECTS = 100000;
+static const size_t RAYS = 100000;
+static const int FRAMES = 20;
+
+void BenchBvh() {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f), size(0.1f, 3.0f);
+    std::vector<Aabb> bounds(OBJECTS);
+    FrustumCuller culler;
+    for (Aabb& box : bounds) {
+        float center[3] = { position(rng), position(rng), position(rng) };
+        float extents[3] = { size(rng), size(rng), size(rng) };
+        for (int axis = 0; axis < 3; axis++) {
+            box.Min[axis] = center[axis] - extents[axis];
+            box.Max[axis] = center[axis] + extents[axis];
+        }
+        culler.Add(center, extents);
+    }
+
+    Bvh bvh;
+    std::vector<uint32_t> proxies(OBJECTS);
+    double start = NowMilliseconds();
+    bvh.Build(bounds.data(), OBJECTS, nullptr, proxies.data());
+    std::cout << OBJECTS << " objects, SAH build " << NowMilliseconds() - start << " ms, height " 
+        << bvh.GetHeight() << ", cost " << bvh.GetCost() << std::endl;
+
+    float f = 1.0f / std::tan(0.5236f);
+    float projection[16] = { f / (16.0f / 9.0f), 0, 0, 0,  0, f, 0, 0,  0, 0, -1.002f, -1,  0, 0, -0.2002f, 0 };
+    Frustum frustum = Frustum::FromMatrix(projection);
+    std::vector<uint32_t> visible;
+
+    start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++)
+        bvh.Cull(frustum, visible);
+    std::cout << "bvh cull: " << (NowMilliseconds() - start) / FRAMES << " ms, " << visible.size() 
+        << " visible" << std::endl;
+    start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++)
+        culler.Cull(frustum, visible, FrustumCuller::Volume::Box, 1);
+    std::cout << "brute force " << FrustumCuller::GetInstructionSet() << " cull: " 
+        << (NowMilliseconds() - start) / FRAMES << " ms, " << visible.size() << " visible" << std::endl;
+
+    // a tenth of the objects move every frame
+    std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+    start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        for (size_t i = frame % 10; i < OBJECTS; i += 10) {
+            float offset[3] = { step(rng), step(rng), step(rng) };
+            for (int axis = 0; axis < 3; axis++) {
+                bounds[i].Min[axis] += offset[axis];
+                bounds[i].Max[axis] += offset[axis];
+            }
+            bvh.Update(proxies[i], bounds[i], false);
+        }
+        bvh.Refit();
+    }
+    std::cout << "move " << OBJECTS / 10 << " + refit: " << (NowMilliseconds() - start) / FRAMES 
+        << " ms, cost " << bvh.GetCost() << std::endl;
+
+    // churn: remove and insert back a tenth of the objects
+    start = NowMilliseconds();
+    for (size_t i = 0; i < OBJECTS; i += 10)
+        bvh.Remove(proxies[i]);
+    for (size_t i = 0; i < OBJECTS; i += 10)
+        proxies[i] = bvh.Insert(bounds[i], (uint32_t)i);
+    std::cout << "remove + insert " << OBJECTS / 10 << ": " << NowMilliseconds() - start << " ms, height " 
+        << bvh.GetHeight() << ", cost " << bvh.GetCost() << std::endl;
+
+    size_t hits = 0;
+    start = NowMilliseconds();
+    for (size_t r = 0; r < RAYS; r++) {
+        float origin[3] = { position(rng), position(rng), -150.0f };
+        float direction[3] = { 0.0f, 0.0f, 1.0f };
+        hits += bvh.Raycast(origin, direction, 300.0f) != Bvh::Null;
+    }
+    std::cout << RAYS << " picking rays: " << NowMilliseconds() - start << " ms, " << hits << " hits" << std::endl;
+}
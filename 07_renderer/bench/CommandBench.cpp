@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "Bench.h"
+#include "CommandList.h"
+#include "Parallel.h"
+#include "Shader.h"
+
+
+static const uint32_t QUADS = 100000;
+static const uint32_t BLOCK = 1024;
+static const int FRAMES = 5;
+
+// some work per draw before the GL calls, as a scene traversal would
+static void QuadRows(uint32_t i, float rows[3][4]) {
+    uint32_t side = (uint32_t)std::ceil(std::sqrt((double)QUADS));
+    float size = 2.0f / side;
+    float angle = (float)i * 0.01f;
+    float c = std::cos(angle) * size, s = std::sin(angle) * size;
+    float values[3][4] = {
+        { c, -s, 0.0f, -1.0f + size * (i % side + 0.5f) },
+        { s, c, 0.0f, -1.0f + size * (i / side + 0.5f) },
+        { 0.0f, 0.0f, 1.0f, 0.0f },
+    };
+    for (int r = 0; r < 3; r++)
+        for (int k = 0; k < 4; k++)
+            rows[r][k] = values[r][k];
+}
+
+void BenchCommands() {
+    GLfloat vertices[] = {
+         0.5f,  0.5f, 0.0f,
+         0.5f, -0.5f, 0.0f,
+        -0.5f, -0.5f, 0.0f,
+        -0.5f,  0.5f, 0.0f
+    };
+    GLubyte indices[] = { 0, 1, 3, 1, 2, 3 };
+
+    GLuint vao, buffers[2];
+    GLCall( glGenVertexArrays(1, &vao) );
+    GLCall( glGenBuffers(2, buffers) );
+    GLCall( glBindVertexArray(vao) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, buffers[0]) );
+    GLCall( glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW) );
+    GLCall( glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0) );
+    GLCall( glEnableVertexAttribArray(0) );
+    GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]) );
+    GLCall( glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW) );
+    GLCall( glBindVertexArray(0) );
+    GLCall( glViewport(0, 0, 256, 256) );
+
+    ShaderProgramSource source = parseShader("../res/shaders/PerObject.shader");
+    GLuint program = CreateShader(source.VertexShader, source.FragmentShader);
+    GLint rows[3] = { glGetUniformLocation(program, "u_Row0"), glGetUniformLocation(program, "u_Row1"),
+        glGetUniformLocation(program, "u_Row2") };
+    GLint color = glGetUniformLocation(program, "u_Color");
+
+    // everything on the context thread
+    double start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        glUseProgram(program);
+        glBindVertexArray(vao);
+        for (uint32_t i = 0; i < QUADS; i++) {
+            float transform[3][4];
+            QuadRows(i, transform);
+            for (int r = 0; r < 3; r++)
+                glUniform4fv(rows[r], 1, transform[r]);
+            glUniform4f(color, (float)(i & 255) / 255.0f, 0.3f, 0.8f, 1.0f);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, 0);
+        }
+        GLCall( glFinish() );
+    }
+    std::cout << QUADS << " draws, direct: " << (NowMilliseconds() - start) / FRAMES << " ms per frame"
+        << std::endl;
+
+    // the blocks are recorded by the jobs, a packet each: the replay keeps
+    // the block order whatever the thread that recorded it
+    CommandLists lists;
+    uint32_t blocks = (QUADS + BLOCK - 1) / BLOCK;
+    for (unsigned int threads = 1; threads <= GetWorkerCount(); threads *= 2) {
+        double record = 0.0, replay = 0.0;
+        ReplayState state;
+        for (int frame = 0; frame < FRAMES; frame++) {
+            start = NowMilliseconds();
+            lists.Reset();
+            ParallelFor(blocks, [&](size_t block) {
+                CommandList& list = lists.GetLocal();
+                list.Packet(block);
+                list.UseProgram(program);
+                list.BindVertexArray(vao);
+                uint32_t end = std::min<uint32_t>(QUADS, (uint32_t)(block + 1) * BLOCK);
+                for (uint32_t i = (uint32_t)block * BLOCK; i < end; i++) {
+                    float transform[3][4];
+                    QuadRows(i, transform);
+                    for (int r = 0; r < 3; r++)
+                        list.Uniform4f(rows[r], transform[r][0], transform[r][1], transform[r][2], transform[r][3]);
+                    list.Uniform4f(color, (float)(i & 255) / 255.0f, 0.3f, 0.8f, 1.0f);
+                    list.DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, 0);
+                }
+            }, threads);
+            double recorded = NowMilliseconds();
+            record += recorded - start;
+
+            state = lists.Execute();
+            GLCall( glFinish() );
+            replay += NowMilliseconds() - recorded;
+        }
+        std::cout << threads << " threads: record " << record / FRAMES << " ms, replay " << replay / FRAMES
+            << " ms per frame (" << state.Commands << " commands, " << state.Draws << " draws, "
+            << state.SkippedBinds << " binds skipped)" << std::endl;
+    }
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < lists.GetCount(); i++)
+        bytes += lists.Get(i).GetSize() * sizeof(uint64_t);
+    std::cout << "recorded " << bytes / 1024 << " KB" << std::endl;
+
+    GLCall( glBindVertexArray(0) );
+    GLCall( glDeleteProgram(program) );
+    GLCall( glDeleteVertexArrays(1, &vao) );
+    GLCall( glDeleteBuffers(2, buffers) );
+}
@@ -0,0 +1,47 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "FrustumCuller.h"
+#include "Parallel.h"
+
+
+static const size_t OBJECTS = 1000000;
+static const int FRAMES = 20;
+
+void BenchCulling() {
+    // random boxes in a 200 units cube around a camera looking down -z
+    FrustumCuller culler;
+    culler.Reserve(OBJECTS);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f), size(0.1f, 3.0f);
+    for (size_t i = 0; i < OBJECTS; i++) {
+        float center[3] = { position(rng), position(rng), position(rng) };
+        float extents[3] = { size(rng), size(rng), size(rng) };
+        culler.Add(center, extents);
+    }
+
+    float f = 1.0f / std::tan(0.5236f);
+    float projection[16] = { f / (16.0f / 9.0f), 0, 0, 0,  0, f, 0, 0,  0, 0, -1.002f, -1,  0, 0, -0.2002f, 0 };
+    Frustum frustum = Frustum::FromMatrix(projection);
+    std::cout << OBJECTS << " objects, " << FrustumCuller::GetInstructionSet() << std::endl;
+
+    std::vector<uint32_t> visible;
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < GetWorkerCount(); threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(GetWorkerCount());
+
+    for (FrustumCuller::Volume volume : { FrustumCuller::Volume::Sphere, FrustumCuller::Volume::Box }) {
+        for (unsigned int threads : threadCounts) {
+            double start = NowMilliseconds();
+            for (int frame = 0; frame < FRAMES; frame++)
+                culler.Cull(frustum, visible, volume, threads);
+            double elapsed = (NowMilliseconds() - start) / FRAMES;
+            std::cout << (volume == FrustumCuller::Volume::Box ? "boxes, " : "spheres, ") << threads 
+                << " threads: " << elapsed << " ms per frame, " << visible.size() << " visible" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "Ecs.h"
+#include "SceneComponents.h"
+
+
+static const size_t ENTITIES = 200000;
+static const int FRAMES = 20;
+
+struct Velocity {
+    float Value[3];
+};
+
+// what the scene would look like without the ECS: one heap object per 
+// entity with everything in it
+struct GameObject {
+    TransformComponent Transform;
+    Velocity Motion;
+    MeshComponent Mesh;
+    MaterialComponent Material;
+    bool Static;
+    char Other[128];    // name, flags, whatever the object also carries
+};
+
+void BenchEcs() {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> random(-1.0f, 1.0f);
+
+    World world;
+    std::vector<std::unique_ptr<GameObject>> objects;
+    std::vector<Entity> entities;
+    double start = NowMilliseconds();
+    for (size_t i = 0; i < ENTITIES; i++) {
+        TransformComponent transform = { { random(rng), random(rng), random(rng) }, { 1.0f, 1.0f, 1.0f } };
+        Velocity velocity = { { random(rng), random(rng), random(rng) } };
+        // a quarter of them don't move: two archetypes
+        if (i % 4)
+            entities.push_back(world.Create(transform, velocity, MeshComponent{ 0 }, MaterialComponent{ 0, 0, 0 }));
+        else
+            entities.push_back(world.Create(transform, MeshComponent{ 0 }, MaterialComponent{ 0, 0, 0 }));
+        objects.emplace_back(new GameObject{ transform, velocity, { 0 }, { 0, 0, 0 }, i % 4 == 0, {} });
+    }
+    std::cout << ENTITIES << " entities created in " << NowMilliseconds() - start << " ms, " 
+        << world.GetArchetypeCount() << " archetypes" << std::endl;
+
+    // the objects are allocated in a row, shuffle them like a real heap would
+    std::shuffle(objects.begin(), objects.end(), rng);
+
+    const float dt = 0.016f;
+    start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        for (std::unique_ptr<GameObject>& object : objects) {
+            if (object->Static)
+                continue;
+            for (int axis = 0; axis < 3; axis++)
+                object->Transform.Position[axis] += object->Motion.Value[axis] * dt;
+        }
+    }
+    std::cout << "objects update: " << (NowMilliseconds() - start) / FRAMES << " ms" << std::endl;
+
+    start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        world.Each<TransformComponent, Velocity>([dt](Entity, TransformComponent& transform, const Velocity& velocity) {
+            for (int axis = 0; axis < 3; axis++)
+                transform.Position[axis] += velocity.Value[axis] * dt;
+        });
+    }
+    std::cout << "ecs update: " << (NowMilliseconds() - start) / FRAMES << " ms" << std::endl;
+
+    start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        world.ParallelEach<TransformComponent, Velocity>(
+            [dt](Entity, TransformComponent& transform, const Velocity& velocity) {
+                for (int axis = 0; axis < 3; axis++)
+                    transform.Position[axis] += velocity.Value[axis] * dt;
+            });
+    }
+    std::cout << "ecs parallel update (" << GetWorkerCount() << " threads): " 
+        << (NowMilliseconds() - start) / FRAMES << " ms" << std::endl;
+
+    // what the renderer does: read transform + material of everything drawn
+    std::vector<InstanceData> instances(ENTITIES);
+    start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        size_t count = 0;
+        world.Each<TransformComponent, MaterialComponent>(
+            [&](Entity, const TransformComponent& transform, const MaterialComponent& material) {
+                transform.ToRows(instances[count].Transform);
+                instances[count++].Color = material.Color;
+            });
+    }
+    std::cout << "ecs instance gather: " << (NowMilliseconds() - start) / FRAMES << " ms" << std::endl;
+
+    // structural changes: velocity added to / removed from a tenth
+    start = NowMilliseconds();
+    for (size_t i = 0; i < ENTITIES; i += 10) {
+        if (world.Has<Velocity>(entities[i]))
+            world.Remove<Velocity>(entities[i]);
+        else
+            world.Add(entities[i], Velocity{ { 0.0f, 1.0f, 0.0f } });
+    }
+    std::cout << "add/remove " << ENTITIES / 10 << " components: " << NowMilliseconds() - start << " ms" << std::endl;
+
+    start = NowMilliseconds();
+    for (Entity entity : entities)
+        world.Destroy(entity);
+    std::cout << "destroy all: " << NowMilliseconds() - start << " ms, " << world.GetEntityCount() 
+        << " left" << std::endl;
+}
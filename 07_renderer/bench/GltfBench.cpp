@@ -0,0 +1,127 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "GltfModel.h"
+#include "Shader.h"
+
+
+// grid of GRID x GRID vertices, positions + 32 bit indices: ~30MB
+static const uint32_t GRID = 1024;
+static const int LOADS = 5;
+
+static void Append(std::string& out, const void* data, size_t size) {
+    out.append((const char*)data, size);
+}
+
+static void AppendU32(std::string& out, uint32_t value) {
+    Append(out, &value, 4);
+}
+
+/**
+ * @brief a glb with 3 primitives: the grid, then 2 the loader must skip (an
+ * index accessor of VEC3, a POSITION without buffer view)
+ */
+static std::string GenerateGlb() {
+    std::string path = (std::filesystem::temp_directory_path() / "renderer_bench_grid.glb").string();
+    if (std::filesystem::exists(path))
+        return path;
+
+    std::cout << "writing " << path << "..." << std::endl;
+    std::vector<float> positions;
+    positions.reserve(GRID * GRID * 3);
+    for (uint32_t y = 0; y < GRID; y++) {
+        for (uint32_t x = 0; x < GRID; x++) {
+            positions.push_back((float)x / (GRID - 1) * 2.0f - 1.0f);
+            positions.push_back((float)y / (GRID - 1) * 2.0f - 1.0f);
+            positions.push_back(0.0f);
+        }
+    }
+    std::vector<uint32_t> indices;
+    indices.reserve((GRID - 1) * (GRID - 1) * 6);
+    for (uint32_t y = 0; y + 1 < GRID; y++) {
+        for (uint32_t x = 0; x + 1 < GRID; x++) {
+            uint32_t i = y * GRID + x;
+            uint32_t quad[6] = { i, i + 1, i + GRID, i + 1, i + GRID + 1, i + GRID };
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+
+    size_t positionBytes = positions.size() * sizeof(float);
+    size_t indexBytes = indices.size() * sizeof(uint32_t);
+    std::string json = "{\"asset\":{\"version\":\"2.0\"},"
+        "\"buffers\":[{\"byteLength\":" + std::to_string(positionBytes + indexBytes) + "}],"
+        "\"bufferViews\":["
+            "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" + std::to_string(positionBytes) + "},"
+            "{\"buffer\":0,\"byteOffset\":" + std::to_string(positionBytes) + ",\"byteLength\":" +
+                std::to_string(indexBytes) + "}],"
+        "\"accessors\":["
+            "{\"bufferView\":0,\"componentType\":5126,\"count\":" + std::to_string(GRID * GRID) +
+                ",\"type\":\"VEC3\"},"
+            "{\"bufferView\":1,\"componentType\":5125,\"count\":" + std::to_string(indices.size()) +
+                ",\"type\":\"SCALAR\"},"
+            "{\"bufferView\":1,\"componentType\":5125,\"count\":" + std::to_string(indices.size() / 3) +
+                ",\"type\":\"VEC3\"},"
+            "{\"componentType\":5126,\"count\":" + std::to_string(GRID * GRID) + ",\"type\":\"VEC3\"}],"
+        "\"meshes\":[{\"primitives\":["
+            "{\"attributes\":{\"POSITION\":0},\"indices\":1},"
+            "{\"attributes\":{\"POSITION\":0},\"indices\":2},"
+            "{\"attributes\":{\"POSITION\":3}}]}]}";
+    while (json.size() % 4)
+        json += ' ';
+
+    // header, JSON chunk, BIN chunk
+    std::string glb;
+    AppendU32(glb, 0x46546C67);
+    AppendU32(glb, 2);
+    AppendU32(glb, (uint32_t)(12 + 8 + json.size() + 8 + positionBytes + indexBytes));
+    AppendU32(glb, (uint32_t)json.size());
+    AppendU32(glb, 0x4E4F534A);
+    glb += json;
+    AppendU32(glb, (uint32_t)(positionBytes + indexBytes));
+    AppendU32(glb, 0x004E4942);
+    Append(glb, positions.data(), positionBytes);
+    Append(glb, indices.data(), indexBytes);
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(glb.data(), glb.size());
+    return path;
+}
+
+void BenchGltf() {
+    std::string path = GenerateGlb();
+    double megabytes = (double)std::filesystem::file_size(path) / (1024.0 * 1024.0);
+    std::cout << path << ": " << megabytes << " MB" << std::endl;
+
+    // the first load warms up the page cache, and prints the skipped primitives
+    GltfModel model;
+    if (!model.LoadGlb(path))
+        return;
+    std::cout << model.GetPrimitives().size() << " of 3 primitives loaded (2 expected to be skipped)" << std::endl;
+
+    double load = 0.0;
+    for (int i = 0; i < LOADS; i++) {
+        double start = NowMilliseconds();
+        model.LoadGlb(path);
+        glFinish();
+        load += NowMilliseconds() - start;
+    }
+    std::cout << "load + upload: " << load / LOADS << " ms, " << megabytes / load * LOADS * 1000.0
+        << " MB/s" << std::endl;
+
+    ShaderProgramSource source = parseShader("../res/shaders/Basic.shader");
+    GLuint program = CreateShader(source.VertexShader, source.FragmentShader);
+    GLCall( glUseProgram(program) );
+    GLCall( glViewport(0, 0, 256, 256) );
+    double start = NowMilliseconds();
+    model.Draw();
+    GLCall( glFinish() );
+    std::cout << "draw: " << NowMilliseconds() - start << " ms, " << model.GetPrimitives()[0].Count / 3
+        << " triangles" << std::endl;
+    GLCall( glDeleteProgram(program) );
+}
@@ -0,0 +1,78 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "Parallel.h"
+#include "SoftwareOcclusion.h"
+
+
+static const size_t OBJECTS = 100000;
+static const int BUILDINGS = 16;
+static const int FRAMES = 20;
+
+// a box as 12 counter clockwise triangles seen from outside
+static void AddBox(std::vector<float>& positions, std::vector<uint32_t>& indices, const Aabb& box) {
+    uint32_t base = (uint32_t)(positions.size() / 3);
+    for (int corner = 0; corner < 8; corner++) {
+        positions.push_back(corner & 1 ? box.Max[0] : box.Min[0]);
+        positions.push_back(corner & 2 ? box.Max[1] : box.Min[1]);
+        positions.push_back(corner & 4 ? box.Max[2] : box.Min[2]);
+    }
+    static const uint32_t FACES[36] = {
+        0, 4, 6, 0, 6, 2,   1, 3, 7, 1, 7, 5,   // -x, +x
+        0, 1, 5, 0, 5, 4,   2, 6, 7, 2, 7, 3,   // -y, +y
+        0, 2, 3, 0, 3, 1,   4, 5, 7, 4, 7, 6,   // -z, +z
+    };
+    for (uint32_t index : FACES)
+        indices.push_back(base + index);
+}
+
+void BenchHiZ() {
+    // a row of buildings in front of a field of small objects
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    for (int i = 0; i < BUILDINGS; i++) {
+        float x = -40.0f + i * 5.0f;
+        AddBox(positions, indices, { { x, -10.0f, -22.0f }, { x + 4.5f, 10.0f, -20.0f } });
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> spread(-60.0f, 60.0f), depth(-100.0f, -25.0f), size(0.2f, 1.0f);
+    std::vector<Aabb> bounds(OBJECTS);
+    for (Aabb& box : bounds) {
+        float center[3] = { spread(rng), spread(rng) * 0.2f, depth(rng) };
+        float extent = size(rng);
+        for (int axis = 0; axis < 3; axis++) {
+            box.Min[axis] = center[axis] - extent;
+            box.Max[axis] = center[axis] + extent;
+        }
+    }
+
+    float f = 1.0f / std::tan(0.5236f);
+    float projection[16] = { f / 2.0f, 0, 0, 0,  0, f, 0, 0,  0, 0, -1.002f, -1,  0, 0, -0.2002f, 0 };
+    SoftwareOcclusion occlusion;
+
+    for (unsigned int threads = 1; threads <= GetWorkerCount(); threads *= 2) {
+        double start = NowMilliseconds();
+        for (int frame = 0; frame < FRAMES; frame++) {
+            occlusion.Begin(projection);
+            occlusion.AddOccluder(positions.data(), 3 * sizeof(float), indices.data(), indices.size());
+            occlusion.Rasterize(threads);
+        }
+        std::cout << occlusion.GetWidth() << "x" << occlusion.GetHeight() << ", " 
+            << occlusion.GetTriangleCount() << " occluder triangles, " << threads << " threads: " 
+            << (NowMilliseconds() - start) / FRAMES << " ms" << std::endl;
+    }
+
+    size_t visible = 0;
+    double start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        visible = 0;
+        for (const Aabb& box : bounds)
+            visible += occlusion.IsVisible(box);
+    }
+    std::cout << "test " << OBJECTS << " boxes: " << (NowMilliseconds() - start) / FRAMES << " ms, " 
+        << visible << " visible" << std::endl;
+}
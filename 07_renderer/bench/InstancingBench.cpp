@@ -0,0 +1,124 @@
+#include <cmath>
+#include <iostream>
+
+#include "Bench.h"
+#include "GpuTimer.h"
+#include "InstanceRenderer.h"
+#include "Shader.h"
+
+
+static const uint32_t PER_OBJECT_QUADS = 100000;
+static const uint32_t INSTANCED_QUADS = 1000000;
+static const int FRAMES = 5;
+
+static void QuadTransform(uint32_t i, uint32_t count, float transform[3][4]) {
+    uint32_t side = (uint32_t)std::ceil(std::sqrt((double)count));
+    float size = 2.0f / side;
+    float x = -1.0f + size * (i % side + 0.5f);
+    float y = -1.0f + size * (i / side + 0.5f);
+    float rows[3][4] = {
+        { size, 0.0f, 0.0f, x },
+        { 0.0f, size, 0.0f, y },
+        { 0.0f, 0.0f, 1.0f, 0.0f },
+    };
+    for (int r = 0; r < 3; r++)
+        for (int c = 0; c < 4; c++)
+            transform[r][c] = rows[r][c];
+}
+
+/**
+ * @brief the 06_vertexArrays way: uniforms + glDrawElements per quad
+ */
+static void PerObject(GLuint vao, uint32_t count) {
+    ShaderProgramSource source = parseShader("../res/shaders/PerObject.shader");
+    GLuint program = CreateShader(source.VertexShader, source.FragmentShader);
+    GLCall( glUseProgram(program) );
+    GLint rows[3] = { glGetUniformLocation(program, "u_Row0"), glGetUniformLocation(program, "u_Row1"), 
+        glGetUniformLocation(program, "u_Row2") };
+    GLint color = glGetUniformLocation(program, "u_Color");
+    GLCall( glBindVertexArray(vao) );
+
+    double cpu = 0.0, gpu = 0.0;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        GpuTimer timer;
+        double start = NowMilliseconds();
+        timer.Begin();
+        // no GLCall in here, a glGetError per call would dominate the timing
+        for (uint32_t i = 0; i < count; i++) {
+            float transform[3][4];
+            QuadTransform(i, count, transform);
+            for (int r = 0; r < 3; r++)
+                glUniform4fv(rows[r], 1, transform[r]);
+            glUniform4f(color, (float)(i & 255) / 255.0f, 0.3f, 0.8f, 1.0f);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, 0);
+        }
+        timer.End();
+        cpu += NowMilliseconds() - start;
+        gpu += timer.GetMilliseconds();
+    }
+    std::cout << "per object: " << count << " quads, " << count << " draws, cpu " << cpu / FRAMES 
+        << " ms, gpu " << gpu / FRAMES << " ms per frame" << std::endl;
+
+    GLCall( glBindVertexArray(0) );
+    GLCall( glDeleteProgram(program) );
+}
+
+static void Instanced(GLuint vao, uint32_t count) {
+    ShaderProgramSource source = parseShader("../res/shaders/Instanced.shader");
+    GLuint program = CreateShader(source.VertexShader, source.FragmentShader);
+    GLCall( glUseProgram(program) );
+
+    InstanceRenderer instances(vao, 1, count);
+
+    double cpu = 0.0, gpu = 0.0;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        GpuTimer timer;
+        double start = NowMilliseconds();
+        timer.Begin();
+        InstanceData* data = instances.Begin(count);
+        for (uint32_t i = 0; i < count; i++) {
+            QuadTransform(i, count, data[i].Transform);
+            data[i].Color = InstanceRenderer::PackColor((float)(i & 255) / 255.0f, 0.3f, 0.8f, 1.0f);
+        }
+        instances.Draw(6, GL_UNSIGNED_BYTE);
+        timer.End();
+        instances.EndFrame();
+        cpu += NowMilliseconds() - start;
+        gpu += timer.GetMilliseconds();
+    }
+    std::cout << "instanced:  " << count << " quads, 1 draw, cpu " << cpu / FRAMES 
+        << " ms, gpu " << gpu / FRAMES << " ms per frame" << std::endl;
+
+    GLCall( glBindVertexArray(0) );
+    GLCall( glDeleteProgram(program) );
+}
+
+void BenchInstancing() {
+    GLfloat vertices[] = {
+         0.5f,  0.5f, 0.0f,
+         0.5f, -0.5f, 0.0f,
+        -0.5f, -0.5f, 0.0f,
+        -0.5f,  0.5f, 0.0f
+    };
+    GLubyte indices[] = { 0, 1, 3, 1, 2, 3 };
+
+    GLuint vao, buffers[2];
+    GLCall( glGenVertexArrays(1, &vao) );
+    GLCall( glGenBuffers(2, buffers) );
+    GLCall( glBindVertexArray(vao) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, buffers[0]) );
+    GLCall( glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW) );
+    GLCall( glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0) );
+    GLCall( glEnableVertexAttribArray(0) );
+    GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]) );
+    GLCall( glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW) );
+    GLCall( glBindVertexArray(0) );
+
+    GLCall( glViewport(0, 0, 256, 256) );
+    PerObject(vao, PER_OBJECT_QUADS);
+    Instanced(vao, PER_OBJECT_QUADS);
+    Instanced(vao, INSTANCED_QUADS);
+
+    GLCall( glDeleteVertexArrays(1, &vao) );
+    GLCall( glDeleteBuffers(2, buffers) );
+}
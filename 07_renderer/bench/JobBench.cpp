@@ -0,0 +1,72 @@
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "JobSystem.h"
+
+
+static const size_t EMPTY_JOBS = 1 << 20;
+static const size_t BATCH = 1024;
+static const size_t CHAIN = 10000;
+static const size_t ELEMENTS = 1 << 24;
+
+// some math per element, so the scaling isn't bound by memory
+static float Work(size_t i) {
+    float x = (float)i;
+    for (int k = 0; k < 8; k++)
+        x = std::sqrt(x + 1.0f);
+    return x;
+}
+
+void BenchJobs() {
+    JobSystem& jobs = JobSystem::Get();
+    std::cout << jobs.GetThreadCount() << " threads" << std::endl;
+
+    // per task cost: empty jobs, waited by batches so they stay in the rings
+    JobCounter counter;
+    double start = NowMilliseconds();
+    for (size_t batch = 0; batch < EMPTY_JOBS / BATCH; batch++) {
+        for (size_t i = 0; i < BATCH; i++)
+            jobs.Run([]() {}, &counter);
+        jobs.Wait(counter);
+    }
+    std::cout << "empty job: " << (NowMilliseconds() - start) * 1e6 / EMPTY_JOBS << " ns" << std::endl;
+
+    // what ParallelFor() used to do: a thread per task
+    start = NowMilliseconds();
+    for (size_t i = 0; i < BATCH; i++)
+        std::thread([]() {}).join();
+    std::cout << "thread spawn + join: " << (NowMilliseconds() - start) * 1e6 / BATCH << " ns" << std::endl;
+
+    // a chain: every job waits for the previous one
+    std::unique_ptr<JobCounter[]> chain(new JobCounter[CHAIN]);
+    start = NowMilliseconds();
+    for (size_t i = 0; i < CHAIN; i++)
+        jobs.Run([]() {}, &chain[i], i ? &chain[i - 1] : nullptr);
+    jobs.Wait(chain[CHAIN - 1]);
+    std::cout << "dependency hop: " << (NowMilliseconds() - start) * 1e6 / CHAIN << " ns" << std::endl;
+
+    // parallel_for cost per grain
+    std::vector<float> out(ELEMENTS);
+    for (size_t grain : { 64, 1024, 16384 }) {
+        start = NowMilliseconds();
+        jobs.ParallelFor(ELEMENTS, grain, [&out](size_t i) { out[i] = (float)i; });
+        std::cout << "parallel_for " << ELEMENTS << " stores, grain " << grain << ": " 
+            << NowMilliseconds() - start << " ms" << std::endl;
+    }
+
+    // scaling curve
+    double single = 0.0;
+    for (unsigned int threads = 1; threads <= GetWorkerCount(); threads *= 2) {
+        JobSystem system(threads);
+        start = NowMilliseconds();
+        system.ParallelFor(ELEMENTS, 4096, [&out](size_t i) { out[i] = Work(i); });
+        double elapsed = NowMilliseconds() - start;
+        if (threads == 1)
+            single = elapsed;
+        std::cout << threads << " threads: " << elapsed << " ms, x" << single / elapsed << std::endl;
+    }
+}
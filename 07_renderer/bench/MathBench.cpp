@@ -0,0 +1,107 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "VectorMath.h"
+
+
+static const size_t MATRICES = 100000;
+static const size_t POINTS = 1000000;
+static const int ROUNDS = 20;
+
+// what the code did before VectorMath.h: float arrays and triple loops
+static void NaiveMultiply(float* out, const float* a, const float* b) {
+    for (int j = 0; j < 4; j++) {
+        for (int r = 0; r < 4; r++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++)
+                sum += a[k * 4 + r] * b[j * 4 + k];
+            out[j * 4 + r] = sum;
+        }
+    }
+}
+
+static void NaiveTransform(float* out, const float* m, const float* p) {
+    for (int r = 0; r < 3; r++) {
+        float sum = m[12 + r];
+        for (int k = 0; k < 3; k++)
+            sum += m[k * 4 + r] * p[k];
+        out[r] = sum;
+    }
+}
+
+static void Report(const char* name, double start, size_t count) {
+    double ms = (NowMilliseconds() - start) / ROUNDS;
+    std::cout << name << ": " << ms << " ms (" << ms * 1e6 / count << " ns each)" << std::endl;
+}
+
+void BenchMath() {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::cout << "avx: " << (MathHasAvx() ? "yes" : "no") << std::endl;
+
+    std::vector<Mat4> a(MATRICES), b(MATRICES), naive(MATRICES), batch(MATRICES);
+    for (size_t i = 0; i < MATRICES; i++) {
+        for (int k = 0; k < 16; k++) {
+            a[i].Values[k] = value(rng);
+            b[i].Values[k] = value(rng);
+        }
+    }
+
+    double start = NowMilliseconds();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < MATRICES; i++)
+            NaiveMultiply(naive[i].Values, a[i].Values, b[i].Values);
+    }
+    Report("mat4 multiply, naive", start, MATRICES);
+
+    start = NowMilliseconds();
+    for (int round = 0; round < ROUNDS; round++)
+        MultiplyMatrices(a.data(), b.data(), batch.data(), MATRICES);
+    Report("mat4 multiply, batch", start, MATRICES);
+
+    float error = 0.0f;
+    for (size_t i = 0; i < MATRICES; i++) {
+        for (int k = 0; k < 16; k++)
+            error = std::max(error, std::fabs(naive[i].Values[k] - batch[i].Values[k]));
+    }
+    std::cout << "max difference " << error << std::endl;
+
+    Mat4 m = Compose({ 1.0f, 2.0f, 3.0f }, Quat::FromAxisAngle(Normalize(Vec3{ 1.0f, 1.0f, 0.0f }), 0.5f),
+        { 2.0f, 2.0f, 2.0f });
+    std::vector<Vec3> points(POINTS), naivePoints(POINTS), batchPoints(POINTS);
+    std::vector<float> x(POINTS), y(POINTS), z(POINTS), outX(POINTS), outY(POINTS), outZ(POINTS);
+    for (size_t i = 0; i < POINTS; i++) {
+        points[i] = { value(rng), value(rng), value(rng) };
+        x[i] = points[i].X;
+        y[i] = points[i].Y;
+        z[i] = points[i].Z;
+    }
+
+    start = NowMilliseconds();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < POINTS; i++)
+            NaiveTransform(&naivePoints[i].X, m.Values, &points[i].X);
+    }
+    Report("transform points, naive", start, POINTS);
+
+    start = NowMilliseconds();
+    for (int round = 0; round < ROUNDS; round++)
+        TransformPoints(m, points.data(), batchPoints.data(), POINTS);
+    Report("transform points, batch (xyz xyz)", start, POINTS);
+
+    start = NowMilliseconds();
+    for (int round = 0; round < ROUNDS; round++)
+        TransformPoints(m, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), POINTS);
+    Report("transform points, batch (xxx yyy zzz)", start, POINTS);
+
+    error = 0.0f;
+    for (size_t i = 0; i < POINTS; i++) {
+        Vec3 reference = naivePoints[i];
+        error = std::max(error, Length(reference - batchPoints[i]));
+        error = std::max(error, Length(reference - Vec3{ outX[i], outY[i], outZ[i] }));
+    }
+    std::cout << "max difference " << error << std::endl;
+}
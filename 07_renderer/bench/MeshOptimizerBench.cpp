@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "MeshOptimizer.h"
+
+
+// grid of GRID x GRID vertices with its triangles shuffled, what an 
+// exporter that does not care about the order gives us
+static const uint32_t GRID = 512;
+
+void BenchMeshOptimizer() {
+    std::vector<float> positions;
+    for (uint32_t y = 0; y < GRID; y++) {
+        for (uint32_t x = 0; x < GRID; x++) {
+            positions.push_back((float)x);
+            positions.push_back((float)y);
+            positions.push_back(0.0f);
+        }
+    }
+
+    std::vector<GLuint> triangles;
+    for (uint32_t y = 0; y + 1 < GRID; y++) {
+        for (uint32_t x = 0; x + 1 < GRID; x++) {
+            GLuint i = y * GRID + x;
+            GLuint quad[6] = { i, i + 1, i + GRID, i + 1, i + GRID + 1, i + GRID };
+            triangles.insert(triangles.end(), quad, quad + 6);
+        }
+    }
+
+    std::vector<uint32_t> order(triangles.size() / 3);
+    for (uint32_t t = 0; t < order.size(); t++)
+        order[t] = t;
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    std::vector<GLuint> indices;
+    indices.reserve(triangles.size());
+    for (uint32_t t : order)
+        indices.insert(indices.end(), &triangles[t * 3], &triangles[t * 3] + 3);
+
+    std::vector<uint8_t> vertices((const uint8_t*)positions.data(), 
+        (const uint8_t*)(positions.data() + positions.size()));
+    VertexBufferLayout layout;
+    layout.Push(GL_FLOAT, 3);
+
+    double start = NowMilliseconds();
+    MeshOptimizationReport report = OptimizeMesh(vertices, indices, layout);
+    double elapsed = NowMilliseconds() - start;
+
+    std::cout << indices.size() / 3 << " triangles optimized in " << elapsed << " ms" << std::endl;
+    PrintMeshOptimizationReport(report);
+}
@@ -0,0 +1,84 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "Bench.h"
+#include "MeshOptimizer.h"
+#include "Meshlets.h"
+#include "Parallel.h"
+
+
+// unit sphere of SEGMENTS x SEGMENTS / 2 quads, ~2M triangles
+static const uint32_t SEGMENTS = 2048;
+static const int FRAMES = 100;
+
+static void Multiply(float out[16], const float a[16], const float b[16]) {
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            out[c * 4 + r] = 0.0f;
+            for (int k = 0; k < 4; k++)
+                out[c * 4 + r] += a[k * 4 + r] * b[c * 4 + k];
+        }
+    }
+}
+
+void BenchMeshlets() {
+    const uint32_t rings = SEGMENTS / 2;
+    std::vector<float> positions;
+    for (uint32_t y = 0; y <= rings; y++) {
+        for (uint32_t x = 0; x < SEGMENTS; x++) {
+            float theta = 3.14159265f * y / rings, phi = 6.2831853f * x / SEGMENTS;
+            positions.push_back(std::sin(theta) * std::cos(phi));
+            positions.push_back(std::cos(theta));
+            positions.push_back(std::sin(theta) * std::sin(phi));
+        }
+    }
+    std::vector<GLuint> triangles;
+    for (uint32_t y = 0; y < rings; y++) {
+        for (uint32_t x = 0; x < SEGMENTS; x++) {
+            GLuint a = y * SEGMENTS + x, b = y * SEGMENTS + (x + 1) % SEGMENTS;
+            // counter clockwise seen from outside
+            GLuint quad[6] = { a, b, b + SEGMENTS, a, b + SEGMENTS, a + SEGMENTS };
+            triangles.insert(triangles.end(), quad, quad + 6);
+        }
+    }
+    size_t vertexCount = positions.size() / 3;
+    std::vector<GLuint> indices(triangles.size());
+    OptimizeVertexCache(indices.data(), triangles.data(), triangles.size(), vertexCount);
+
+    double start = NowMilliseconds();
+    std::vector<Meshlet> meshlets = BuildMeshlets(indices.data(), indices.size(), positions.data(), 
+        vertexCount, 3 * sizeof(float));
+    std::cout << meshlets.size() << " meshlets for " << indices.size() / 3 << " triangles in " 
+        << NowMilliseconds() - start << " ms" << std::endl;
+
+    // camera 2 units in front of the sphere, looking at it, 60 degrees 16:9
+    float f = 1.0f / std::tan(0.5236f);
+    float projection[16] = { f / (16.0f / 9.0f), 0, 0, 0,  0, f, 0, 0,  0, 0, -1.0002f, -1,  0, 0, -0.20002f, 0 };
+    float view[16] = { 1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  0, 0, -3.0f, 1 };
+    float viewProjection[16];
+    Multiply(viewProjection, projection, view);
+    Frustum frustum = Frustum::FromMatrix(viewProjection);
+    const float camera[3] = { 0.0f, 0.0f, 3.0f };
+
+    std::vector<uint32_t> visible;
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < GetWorkerCount(); threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(GetWorkerCount());
+
+    for (unsigned int threads : threadCounts) {
+        start = NowMilliseconds();
+        for (int frame = 0; frame < FRAMES; frame++)
+            CullMeshlets(meshlets, frustum, camera, visible, threads);
+        std::cout << threads << " threads: " << (NowMilliseconds() - start) / FRAMES << " ms per frame" << std::endl;
+    }
+
+    size_t triangleCount = 0;
+    for (uint32_t m : visible)
+        triangleCount += meshlets[m].TriangleCount;
+    DrawCommandBuilder builder((uint32_t)meshlets.size());
+    uint32_t draws = AddMeshletDraws(builder, meshlets, visible, GL_UNSIGNED_INT);
+    std::cout << visible.size() << " visible meshlets, " << triangleCount << " of " << indices.size() / 3 
+        << " triangles, " << draws << " draw commands after merging runs" << std::endl;
+}
@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "Bench.h"
+#include "MeshFile.h"
+#include "ObjLoader.h"
+#include "Parallel.h"
+
+
+// grid of GRID x GRID vertices with positions, uvs and normals: ~110MB
+static const uint32_t GRID = 800;
+
+static std::string GenerateObj() {
+    std::string path = (std::filesystem::temp_directory_path() / "renderer_bench_grid.obj").string();
+    if (std::filesystem::exists(path))
+        return path;
+
+    std::cout << "writing " << path << "..." << std::endl;
+    std::ofstream file(path);
+    char line[128];
+    for (uint32_t y = 0; y < GRID; y++) {
+        for (uint32_t x = 0; x < GRID; x++) {
+            float u = (float)x / (GRID - 1), v = (float)y / (GRID - 1);
+            snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n", 
+                u * 100.0f, v * 100.0f, (float)((x * 7 + y * 13) % 17) * 0.01f, u, v, 0.0f, 0.0f, 1.0f);
+            file << line;
+        }
+    }
+    for (uint32_t y = 0; y + 1 < GRID; y++) {
+        for (uint32_t x = 0; x + 1 < GRID; x++) {
+            uint32_t i = y * GRID + x + 1;
+            snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n", 
+                i, i, i, i + 1, i + 1, i + 1, i + GRID + 1, i + GRID + 1, i + GRID + 1, 
+                i + GRID, i + GRID, i + GRID);
+            file << line;
+        }
+    }
+    return path;
+}
+
+void BenchObjLoader() {
+    std::string path = GenerateObj();
+    double megabytes = (double)std::filesystem::file_size(path) / (1024.0 * 1024.0);
+    std::cout << path << ": " << megabytes << " MB" << std::endl;
+
+    // the first load warms up the page cache, we want to measure parsing
+    ObjMesh mesh;
+    LoadObj(path, mesh);
+
+    // 1, 2, 4... and always all the cores last
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < GetWorkerCount(); threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(GetWorkerCount());
+
+    double single = 0.0;
+    for (unsigned int threads : threadCounts) {
+        double start = NowMilliseconds();
+        if (!LoadObj(path, mesh, threads))
+            return;
+        double elapsed = NowMilliseconds() - start;
+        if (threads == 1)
+            single = elapsed;
+
+        std::cout << threads << " threads: " << elapsed << " ms, " << megabytes / elapsed * 1000.0 
+            << " MB/s, " << single / elapsed << "x" << std::endl;
+    }
+    std::cout << mesh.VertexCount << " vertices, " << mesh.Indices.size() / 3 << " triangles" << std::endl;
+
+    // the same mesh converted offline, loading is now mmap + upload
+    std::string meshPath = (std::filesystem::temp_directory_path() / "renderer_bench_grid.mesh").string();
+    if (!WriteMeshFile(meshPath, mesh.Vertices.data(), mesh.VertexCount, mesh.Layout, mesh.Indices.data(), 
+        (uint32_t)mesh.Indices.size()))
+        return;
+
+    MeshFile meshFile;
+    meshFile.Load(meshPath);
+    double start = NowMilliseconds();
+    meshFile.Load(meshPath);
+    glFinish();
+    double elapsed = NowMilliseconds() - start;
+    std::cout << ".mesh load + upload: " << elapsed << " ms, " << single / elapsed << "x" << std::endl;
+}
@@ -0,0 +1,177 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "Bench.h"
+#include "GpuTimer.h"
+#include "OcclusionQueries.h"
+#include "Shader.h"
+
+
+// GRID x GRID spheres of ~8k triangles behind a wall hiding most of them
+static const uint32_t GRID = 32;
+static const uint32_t SEGMENTS = 64;
+static const int FRAMES = 20;
+
+enum class Mode { None, Conditional, Latent };
+
+struct Scene {
+    GLuint VAO;
+    GLuint Buffers[2];
+    GLsizei SphereIndices;
+    GLint CubeBaseVertex;
+    GLintptr CubeOffset;
+    GLint Rows[3];
+    GLint Color;
+};
+
+static void SetTransform(const Scene& scene, float x, float y, float z, float sx, float sy, float sz) {
+    float rows[3][4] = { { sx, 0.0f, 0.0f, x }, { 0.0f, sy, 0.0f, y }, { 0.0f, 0.0f, sz, z } };
+    for (int r = 0; r < 3; r++)
+        glUniform4fv(scene.Rows[r], 1, rows[r]);
+}
+
+static void DrawSphere(const Scene& scene, uint32_t i) {
+    float x = -0.95f + 1.9f * (i % GRID + 0.5f) / GRID, y = -0.95f + 1.9f * (i / GRID + 0.5f) / GRID;
+    SetTransform(scene, x, y, 0.5f, 0.025f, 0.025f, 0.025f);
+    glDrawElements(GL_TRIANGLES, scene.SphereIndices, GL_UNSIGNED_INT, 0);
+}
+
+static void DrawProxy(const Scene& scene, uint32_t i) {
+    float x = -0.95f + 1.9f * (i % GRID + 0.5f) / GRID, y = -0.95f + 1.9f * (i / GRID + 0.5f) / GRID;
+    SetTransform(scene, x, y, 0.5f, 0.025f, 0.025f, 0.025f);
+    glDrawElementsBaseVertex(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (const GLvoid*)scene.CubeOffset, scene.CubeBaseVertex);
+}
+
+static Scene CreateScene(GLuint program) {
+    std::vector<float> vertices;
+    std::vector<GLuint> indices;
+    for (uint32_t y = 0; y <= SEGMENTS / 2; y++) {
+        for (uint32_t x = 0; x <= SEGMENTS; x++) {
+            float theta = 3.14159265f * y / (SEGMENTS / 2), phi = 6.2831853f * x / SEGMENTS;
+            vertices.insert(vertices.end(), { std::sin(theta) * std::cos(phi), std::cos(theta), 
+                std::sin(theta) * std::sin(phi) });
+        }
+    }
+    for (uint32_t y = 0; y < SEGMENTS / 2; y++) {
+        for (uint32_t x = 0; x < SEGMENTS; x++) {
+            GLuint a = y * (SEGMENTS + 1) + x, b = a + SEGMENTS + 1;
+            indices.insert(indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+        }
+    }
+
+    Scene scene;
+    scene.SphereIndices = (GLsizei)indices.size();
+    scene.CubeBaseVertex = (GLint)(vertices.size() / 3);
+    scene.CubeOffset = (GLintptr)(indices.size() * sizeof(GLuint));
+    for (int corner = 0; corner < 8; corner++)
+        vertices.insert(vertices.end(), { corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : -1.0f });
+    indices.insert(indices.end(), { 0, 2, 1, 1, 2, 3,  4, 5, 6, 5, 7, 6,  0, 1, 4, 1, 5, 4,  
+        2, 6, 3, 3, 6, 7,  0, 4, 2, 2, 4, 6,  1, 3, 5, 3, 7, 5 });
+
+    GLCall( glGenVertexArrays(1, &scene.VAO) );
+    GLCall( glGenBuffers(2, scene.Buffers) );
+    GLCall( glBindVertexArray(scene.VAO) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, scene.Buffers[0]) );
+    GLCall( glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW) );
+    GLCall( glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (GLvoid*)0) );
+    GLCall( glEnableVertexAttribArray(0) );
+    GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, scene.Buffers[1]) );
+    GLCall( glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW) );
+
+    scene.Rows[0] = glGetUniformLocation(program, "u_Row0");
+    scene.Rows[1] = glGetUniformLocation(program, "u_Row1");
+    scene.Rows[2] = glGetUniformLocation(program, "u_Row2");
+    scene.Color = glGetUniformLocation(program, "u_Color");
+    return scene;
+}
+
+static void Run(const Scene& scene, Mode mode, OcclusionQueries& queries) {
+    const uint32_t count = GRID * GRID;
+    double gpu = 0.0, cpu = 0.0;
+    size_t drawn = 0;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        GpuTimer timer;
+        double start = NowMilliseconds();
+        timer.Begin();
+        queries.BeginFrame();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // the wall, in front of the middle of the grid
+        glUniform4f(scene.Color, 0.5f, 0.5f, 0.5f, 1.0f);
+        SetTransform(scene, 0.0f, 0.0f, -0.5f, 0.7f, 0.7f, 0.01f);
+        glDrawElementsBaseVertex(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (const GLvoid*)scene.CubeOffset, scene.CubeBaseVertex);
+        glUniform4f(scene.Color, 0.2f, 0.3f, 0.8f, 1.0f);
+
+        size_t frameDrawn = 0;
+        if (mode == Mode::None) {
+            for (uint32_t i = 0; i < count; i++)
+                DrawSphere(scene, i);
+            frameDrawn = count;
+        } else if (mode == Mode::Conditional) {
+            OcclusionQueries::BeginProxies();
+            for (uint32_t i = 0; i < count; i++) {
+                queries.BeginQuery(i);
+                DrawProxy(scene, i);
+                queries.EndQuery();
+            }
+            OcclusionQueries::EndProxies();
+            for (uint32_t i = 0; i < count; i++) {
+                queries.BeginConditionalRender(i);
+                DrawSphere(scene, i);
+                OcclusionQueries::EndConditionalRender();
+            }
+            frameDrawn = count;
+        } else {
+            // visible objects are their own query, the hidden ones get a proxy
+            for (uint32_t i = 0; i < count; i++) {
+                if (!queries.IsVisible(i))
+                    continue;
+                queries.BeginQuery(i);
+                DrawSphere(scene, i);
+                queries.EndQuery();
+                frameDrawn++;
+            }
+            OcclusionQueries::BeginProxies();
+            for (uint32_t i = 0; i < count; i++) {
+                if (queries.IsVisible(i))
+                    continue;
+                queries.BeginQuery(i);
+                DrawProxy(scene, i);
+                queries.EndQuery();
+            }
+            OcclusionQueries::EndProxies();
+        }
+        timer.End();
+        cpu += NowMilliseconds() - start;
+        gpu += timer.GetMilliseconds();
+        drawn += frameDrawn;
+    }
+
+    const char* names[] = { "no culling:  ", "conditional: ", "latent:      " };
+    std::cout << names[(int)mode] << drawn / FRAMES << " spheres recorded, cpu " << cpu / FRAMES 
+        << " ms, gpu " << gpu / FRAMES << " ms per frame" << std::endl;
+}
+
+void BenchOcclusion() {
+    ShaderProgramSource source = parseShader("../res/shaders/PerObject.shader");
+    GLuint program = CreateShader(source.VertexShader, source.FragmentShader);
+    GLCall( glUseProgram(program) );
+    Scene scene = CreateScene(program);
+
+    OcclusionQueries queries(GRID * GRID);
+    std::cout << GRID * GRID << " spheres of " << scene.SphereIndices / 3 << " triangles, queries: " 
+        << (queries.GetTarget() == GL_ANY_SAMPLES_PASSED_CONSERVATIVE ? "conservative" : "exact") << std::endl;
+
+    GLCall( glViewport(0, 0, 256, 256) );
+    GLCall( glEnable(GL_DEPTH_TEST) );
+    Run(scene, Mode::None, queries);
+    Run(scene, Mode::Conditional, queries);
+    Run(scene, Mode::Latent, queries);
+    GLCall( glDisable(GL_DEPTH_TEST) );
+
+    GLCall( glBindVertexArray(0) );
+    GLCall( glDeleteVertexArrays(1, &scene.VAO) );
+    GLCall( glDeleteBuffers(2, scene.Buffers) );
+    GLCall( glDeleteProgram(program) );
+}
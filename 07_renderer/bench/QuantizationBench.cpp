@@ -0,0 +1,114 @@
+#include <iostream>
+#include <vector>
+
+#include "Bench.h"
+#include "GpuTimer.h"
+#include "Shader.h"
+#include "VertexQuantizer.h"
+
+
+// grid of GRID x GRID vertices: position, normal, uv as floats
+static const uint32_t GRID = 1024;
+static const int DRAWS = 20;
+
+static GLuint UploadMesh(const void* vertices, GLsizeiptr size, const VertexBufferLayout& layout, 
+    const std::vector<GLuint>& indices, GLuint buffers[2]) {
+
+    GLuint vao;
+    GLCall( glGenVertexArrays(1, &vao) );
+    GLCall( glGenBuffers(2, buffers) );
+    GLCall( glBindVertexArray(vao) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, buffers[0]) );
+    GLCall( glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW) );
+    layout.Apply();
+    GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]) );
+    GLCall( glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), 
+        GL_STATIC_DRAW) );
+    GLCall( glBindVertexArray(0) );
+    return vao;
+}
+
+static double TimeDraws(GLuint vao, GLsizei indexCount, GLuint program, const AttributeBounds& bounds) {
+    GLCall( glUseProgram(program) );
+    GLCall( glUniform3fv(glGetUniformLocation(program, "u_PosScale"), 1, bounds.Scale) );
+    GLCall( glUniform3fv(glGetUniformLocation(program, "u_PosOffset"), 1, bounds.Offset) );
+    GLCall( glBindVertexArray(vao) );
+
+    // warm up, then measure
+    GLCall( glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0) );
+    GpuTimer timer;
+    timer.Begin();
+    for (int i = 0; i < DRAWS; i++) {
+        GLCall( glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0) );
+    }
+    timer.End();
+    GLCall( glBindVertexArray(0) );
+    return timer.GetMilliseconds() / DRAWS;
+}
+
+void BenchQuantization() {
+    std::vector<float> vertices;
+    vertices.reserve(GRID * GRID * 8);
+    for (uint32_t y = 0; y < GRID; y++) {
+        for (uint32_t x = 0; x < GRID; x++) {
+            float u = (float)x / (GRID - 1), v = (float)y / (GRID - 1);
+            float position[3] = { u * 2.0f - 1.0f, v * 2.0f - 1.0f, 0.0f };
+            float normal[3] = { 0.0f, 0.0f, 1.0f };
+            vertices.insert(vertices.end(), position, position + 3);
+            vertices.insert(vertices.end(), normal, normal + 3);
+            vertices.push_back(u * 4.0f); // tiling uv, remapped to the bounds
+            vertices.push_back(v * 4.0f);
+        }
+    }
+
+    std::vector<GLuint> indices;
+    indices.reserve((GRID - 1) * (GRID - 1) * 6);
+    for (uint32_t y = 0; y + 1 < GRID; y++) {
+        for (uint32_t x = 0; x + 1 < GRID; x++) {
+            GLuint i = y * GRID + x;
+            GLuint quad[6] = { i, i + 1, i + GRID, i + 1, i + GRID + 1, i + GRID };
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+
+    VertexBufferLayout source;
+    source.Push(GL_FLOAT, 3);
+    source.Push(GL_FLOAT, 3);
+    source.Push(GL_FLOAT, 2);
+
+    VertexBufferLayout target;
+    target.Push(GL_SHORT, 4, GL_TRUE);                  // position, snorm16
+    target.Push(GL_INT_2_10_10_10_REV, 4, GL_TRUE);     // normal
+    target.Push(GL_UNSIGNED_SHORT, 2, GL_TRUE);         // uv, unorm16
+
+    QuantizedVertices quantized = QuantizeVertices(vertices.data(), GRID * GRID, source, target);
+    PrintQuantizationReport(quantized.Report);
+
+    GLuint floatBuffers[2], quantizedBuffers[2];
+    GLuint floatVAO = UploadMesh(vertices.data(), vertices.size() * sizeof(float), source, indices, 
+        floatBuffers);
+    GLuint quantizedVAO = UploadMesh(quantized.Data.data(), quantized.Data.size(), quantized.Layout, 
+        indices, quantizedBuffers);
+
+    ShaderProgramSource shader = parseShader("../res/shaders/Quantized.shader");
+    GLuint program = CreateShader(shader.VertexShader, shader.FragmentShader);
+
+    // tiny viewport: we want to measure vertex fetch, not fill rate
+    GLCall( glViewport(0, 0, 64, 64) );
+
+    AttributeBounds identity = {{0.0f, 0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f, 1.0f}};
+    double floatMs = TimeDraws(floatVAO, (GLsizei)indices.size(), program, identity);
+    double quantizedMs = TimeDraws(quantizedVAO, (GLsizei)indices.size(), program, quantized.Bounds[0]);
+
+    double vertexCount = (double)GRID * GRID;
+    std::cout << "float:     " << floatMs << " ms/draw, " << vertexCount / floatMs * 1e-3 
+        << " Mvertices/s" << std::endl;
+    std::cout << "quantized: " << quantizedMs << " ms/draw, " << vertexCount / quantizedMs * 1e-3 
+        << " Mvertices/s (" << floatMs / quantizedMs << "x)" << std::endl;
+
+    GLCall( glDeleteProgram(program) );
+    GLCall( glDeleteVertexArrays(1, &floatVAO) );
+    GLCall( glDeleteVertexArrays(1, &quantizedVAO) );
+    GLCall( glDeleteBuffers(2, floatBuffers) );
+    GLCall( glDeleteBuffers(2, quantizedBuffers) );
+}
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "RenderQueue.h"
+
+
+static const int FRAMES = 20;
+
+static void PrintBinds(const char* name, const BindStats& stats) {
+    std::cout << name << stats.Programs << " programs, " << stats.Materials << " materials, " 
+        << stats.VAOs << " VAOs" << std::endl;
+}
+
+static void Run(uint32_t count) {
+    // a scene with a realistic amount of state: 16 programs, 512 materials, 
+    // 64 VAOs, 10% translucent
+    std::mt19937 rng(7);
+    std::vector<DrawKey> draws(count);
+    for (DrawKey& draw : draws) {
+        draw.Layer = rng() % 100 < 5 ? 1 : 0;
+        draw.Translucent = rng() % 10 == 0;
+        draw.Program = (uint16_t)(rng() % 16);
+        draw.Material = (uint16_t)(draw.Program * 32 + rng() % 32);
+        draw.VAO = (uint16_t)(rng() % 64);
+        draw.Depth = (float)(rng() % 100000) / 100000.0f;
+    }
+
+    RenderQueue queue;
+    queue.Reserve(count);
+
+    double radix = 0.0, standard = 0.0;
+    std::vector<RenderQueue::Item> copy;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        queue.Clear();
+        for (uint32_t i = 0; i < count; i++)
+            queue.Push(draws[i], i);
+        copy = queue.GetItems();
+
+        double start = NowMilliseconds();
+        queue.Sort();
+        radix += NowMilliseconds() - start;
+
+        start = NowMilliseconds();
+        std::stable_sort(copy.begin(), copy.end(), 
+            [](const RenderQueue::Item& a, const RenderQueue::Item& b) { return a.Key < b.Key; });
+        standard += NowMilliseconds() - start;
+    }
+
+    std::cout << count << " keys: radix sort " << radix / FRAMES << " ms, std::stable_sort " 
+        << standard / FRAMES << " ms per frame" << std::endl;
+
+    RenderQueue unsorted;
+    for (uint32_t i = 0; i < count; i++)
+        unsorted.Push(draws[i], i);
+    BindStats before = unsorted.CountBinds();
+    BindStats after = queue.CountBinds();
+    PrintBinds("  submission order: ", before);
+    PrintBinds("  sorted:           ", after);
+    std::cout << "  binds saved: " << (before.Programs + before.Materials + before.VAOs) - 
+        (after.Programs + after.Materials + after.VAOs) << std::endl;
+}
+
+void BenchRenderQueue() {
+    Run(100000);
+    Run(1000000);
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <vector>
+
+#include "Bench.h"
+#include "GpuTimer.h"
+#include "IndexData.h"
+#include "MeshOptimizer.h"
+#include "Shader.h"
+
+
+// grid of GRID x GRID vertices, the biggest that keeps 16 bit strips 
+// (0xFFFF is the restart index)
+static const uint32_t GRID = 255;
+static const int DRAWS = 50;
+static const int FRAMES = 5;
+
+static double Draw(GLuint vao, GLenum mode, const IndexData& indices) {
+    GLCall( glBindVertexArray(vao) );
+    double gpu = 0.0;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        GpuTimer timer;
+        timer.Begin();
+        for (int draw = 0; draw < DRAWS; draw++)
+            glDrawElements(mode, indices.Count, indices.Type, 0);
+        timer.End();
+        gpu += timer.GetMilliseconds();
+    }
+    GLCall( glBindVertexArray(0) );
+    return gpu / FRAMES;
+}
+
+static GLuint Upload(const std::vector<float>& positions, const IndexData& indices, GLuint buffers[2]) {
+    GLuint vao;
+    GLCall( glGenVertexArrays(1, &vao) );
+    GLCall( glGenBuffers(2, buffers) );
+    GLCall( glBindVertexArray(vao) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, buffers[0]) );
+    GLCall( glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float), positions.data(), GL_STATIC_DRAW) );
+    GLCall( glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (GLvoid*)0) );
+    GLCall( glEnableVertexAttribArray(0) );
+    GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]) );
+    GLCall( glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.Bytes.size(), indices.Bytes.data(), GL_STATIC_DRAW) );
+    GLCall( glBindVertexArray(0) );
+    return vao;
+}
+
+void BenchStrips() {
+    std::vector<float> positions;
+    for (uint32_t y = 0; y < GRID; y++) {
+        for (uint32_t x = 0; x < GRID; x++) {
+            positions.push_back((float)x / (GRID - 1) * 2.0f - 1.0f);
+            positions.push_back((float)y / (GRID - 1) * 2.0f - 1.0f);
+            positions.push_back(0.0f);
+        }
+    }
+    std::vector<GLuint> triangles;
+    for (uint32_t y = 0; y + 1 < GRID; y++) {
+        for (uint32_t x = 0; x + 1 < GRID; x++) {
+            GLuint i = y * GRID + x;
+            GLuint quad[6] = { i, i + 1, i + GRID, i + 1, i + GRID + 1, i + GRID };
+            triangles.insert(triangles.end(), quad, quad + 6);
+        }
+    }
+    std::vector<GLuint> list(triangles.size());
+    OptimizeVertexCache(list.data(), triangles.data(), triangles.size(), positions.size() / 3);
+
+    double start = NowMilliseconds();
+    std::vector<GLuint> strip = StripifyTriangles(list.data(), (uint32_t)list.size());
+    double elapsed = NowMilliseconds() - start;
+
+    IndexData listIndices = NarrowIndices(list.data(), (uint32_t)list.size());
+    IndexData stripIndices = NarrowStripIndices(strip.data(), (uint32_t)strip.size());
+    std::cout << list.size() / 3 << " triangles stripified in " << elapsed << " ms" << std::endl;
+    std::cout << "list:  " << listIndices.Count << " indices, " << listIndices.Bytes.size() << " bytes" << std::endl;
+    std::cout << "strip: " << stripIndices.Count << " indices, " << stripIndices.Bytes.size() << " bytes ("
+        << 100.0 * stripIndices.Bytes.size() / listIndices.Bytes.size() << "%)" << std::endl;
+
+    ShaderProgramSource source = parseShader("../res/shaders/PerObject.shader");
+    GLuint program = CreateShader(source.VertexShader, source.FragmentShader);
+    GLCall( glUseProgram(program) );
+    GLCall( glUniform4f(glGetUniformLocation(program, "u_Row0"), 1.0f, 0.0f, 0.0f, 0.0f) );
+    GLCall( glUniform4f(glGetUniformLocation(program, "u_Row1"), 0.0f, 1.0f, 0.0f, 0.0f) );
+    GLCall( glUniform4f(glGetUniformLocation(program, "u_Row2"), 0.0f, 0.0f, 1.0f, 0.0f) );
+    GLCall( glUniform4f(glGetUniformLocation(program, "u_Color"), 0.2f, 0.3f, 0.8f, 1.0f) );
+    GLCall( glViewport(0, 0, 256, 256) );
+
+    GLuint listBuffers[2], stripBuffers[2];
+    GLuint listVAO = Upload(positions, listIndices, listBuffers);
+    GLuint stripVAO = Upload(positions, stripIndices, stripBuffers);
+
+    double listTime = Draw(listVAO, GL_TRIANGLES, listIndices);
+    GLCall( glEnable(GL_PRIMITIVE_RESTART) );
+    GLCall( glPrimitiveRestartIndex(GetRestartIndex(stripIndices.Type)) );
+    double stripTime = Draw(stripVAO, GL_TRIANGLE_STRIP, stripIndices);
+    GLCall( glDisable(GL_PRIMITIVE_RESTART) );
+
+    std::cout << DRAWS << " draws, list gpu " << listTime << " ms, strip gpu " << stripTime 
+        << " ms per frame" << std::endl;
+
+    GLCall( glDeleteVertexArrays(1, &listVAO) );
+    GLCall( glDeleteVertexArrays(1, &stripVAO) );
+    GLCall( glDeleteBuffers(2, listBuffers) );
+    GLCall( glDeleteBuffers(2, stripBuffers) );
+    GLCall( glDeleteProgram(program) );
+}
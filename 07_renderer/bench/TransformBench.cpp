@@ -0,0 +1,114 @@
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "Parallel.h"
+#include "TransformHierarchy.h"
+
+
+static const int ROOTS = 1000;
+static const int CHILDREN = 4;
+static const int DEPTH = 5;
+static const int FRAMES = 20;
+
+// the usual scene graph: heap nodes, children pointers, recursive update
+struct SceneNode {
+    float Local[16];
+    float World[16];
+    std::vector<std::unique_ptr<SceneNode>> Children;
+};
+
+static void Multiply(float* out, const float* a, const float* b) {
+    for (int j = 0; j < 4; j++) {
+        for (int r = 0; r < 4; r++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++)
+                sum += a[k * 4 + r] * b[j * 4 + k];
+            out[j * 4 + r] = sum;
+        }
+    }
+}
+
+static void UpdateNode(SceneNode& node, const float* parent) {
+    if (parent)
+        Multiply(node.World, parent, node.Local);
+    else
+        std::copy(node.Local, node.Local + 16, node.World);
+    for (std::unique_ptr<SceneNode>& child : node.Children)
+        UpdateNode(*child, node.World);
+}
+
+static void RandomLocal(std::mt19937& rng, float m[16]) {
+    std::uniform_real_distribution<float> angle(0.0f, 6.2832f), offset(-1.0f, 1.0f);
+    float a = angle(rng), c = std::cos(a), s = std::sin(a);
+    float local[16] = { c, s, 0, 0,  -s, c, 0, 0,  0, 0, 1, 0,  offset(rng), offset(rng), offset(rng), 1 };
+    std::copy(local, local + 16, m);
+}
+
+static void Build(std::mt19937& rng, SceneNode& node, TransformHierarchy& hierarchy, 
+    TransformHierarchy::Node handle, int depth, std::vector<std::pair<SceneNode*, TransformHierarchy::Node>>& pairs) {
+
+    pairs.push_back({ &node, handle });
+    if (depth + 1 == DEPTH)
+        return;
+    for (int c = 0; c < CHILDREN; c++) {
+        SceneNode* child = new SceneNode();
+        RandomLocal(rng, child->Local);
+        node.Children.emplace_back(child);
+        Build(rng, *child, hierarchy, hierarchy.Add(child->Local, handle), depth + 1, pairs);
+    }
+}
+
+void BenchTransforms() {
+    std::mt19937 rng(42);
+    std::vector<std::unique_ptr<SceneNode>> roots;
+    TransformHierarchy hierarchy;
+    std::vector<std::pair<SceneNode*, TransformHierarchy::Node>> pairs;
+    for (int r = 0; r < ROOTS; r++) {
+        SceneNode* root = new SceneNode();
+        RandomLocal(rng, root->Local);
+        roots.emplace_back(root);
+        Build(rng, *root, hierarchy, hierarchy.Add(root->Local), 0, pairs);
+    }
+
+    double start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        for (std::unique_ptr<SceneNode>& root : roots)
+            UpdateNode(*root, nullptr);
+    }
+    std::cout << hierarchy.GetNodeCount() << " nodes, " << DEPTH << " levels, recursive scalar: " 
+        << (NowMilliseconds() - start) / FRAMES << " ms" << std::endl;
+
+    // the first Update() sorts
+    start = NowMilliseconds();
+    hierarchy.Update();
+    std::cout << "first update (with sort): " << NowMilliseconds() - start << " ms" << std::endl;
+
+    for (unsigned int threads = 1; threads <= GetWorkerCount(); threads *= 2) {
+        start = NowMilliseconds();
+        for (int frame = 0; frame < FRAMES; frame++)
+            hierarchy.Update(threads);
+        std::cout << "hierarchy update, " << threads << " threads: " << (NowMilliseconds() - start) / FRAMES 
+            << " ms" << std::endl;
+    }
+
+    float error = 0.0f;
+    for (const auto& pair : pairs) {
+        const float* world = hierarchy.GetWorld(pair.second);
+        for (int i = 0; i < 16; i++)
+            error = std::max(error, std::fabs(world[i] - pair.first->World[i]));
+    }
+    std::cout << "max difference " << error << std::endl;
+
+    std::vector<TransformHierarchy::Node> nodes(pairs.size());
+    for (size_t i = 0; i < pairs.size(); i++)
+        nodes[i] = pairs[i].second;
+    std::vector<InstanceData> instances(nodes.size());
+    start = NowMilliseconds();
+    for (int frame = 0; frame < FRAMES; frame++)
+        hierarchy.WriteInstances(nodes.data(), nodes.size(), instances.data());
+    std::cout << "write instances: " << (NowMilliseconds() - start) / FRAMES << " ms" << std::endl;
+}
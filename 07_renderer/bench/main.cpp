@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+
+#include "Bench.h"
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+
+struct Benchmark {
+    const char* Name;
+    void (*Run)();
+    bool NeedsContext;
+};
+
+static const Benchmark BENCHMARKS[] = {
+    { "quantization", BenchQuantization, true },
+    { "meshopt", BenchMeshOptimizer, false },
+    { "instancing", BenchInstancing, true },
+    { "renderqueue", BenchRenderQueue, false },
+    { "obj", BenchObjLoader, true },
+    { "gltf", BenchGltf, true },
+    { "lod", BenchLod, false },
+    { "meshlets", BenchMeshlets, true },
+    { "strips", BenchStrips, true },
+    { "culling", BenchCulling, false },
+    { "bvh", BenchBvh, false },
+    { "occlusion", BenchOcclusion, true },
+    { "hiz", BenchHiZ, false },
+    { "ecs", BenchEcs, false },
+    { "jobs", BenchJobs, false },
+    { "transforms", BenchTransforms, false },
+    { "math", BenchMath, false },
+    { "commands", BenchCommands, true },
+};
+
+// run every benchmark, or only the one named on the command line:
+// ./renderer_bench [name]
+int main(int argc, char** argv)
+{
+    GLFWwindow* window = nullptr;
+    if (glfwInit()) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        window = glfwCreateWindow(256, 256, "bench", nullptr, nullptr);
+    }
+
+    // no GPU (or no display): the CPU only benchmarks still run
+    if (window) {
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(0);
+
+        glewExperimental = GL_TRUE;
+        GLenum err = glewInit();
+        if (err != GLEW_OK) {
+            std::cout << "Error: " << glewGetErrorString(err) << std::endl;
+            return -1;
+        }
+        std::cout << "GLVersion: " << glGetString(GL_VERSION) << std::endl;
+        std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+    }
+    else
+        std::cout << "No OpenGL context, skipping the GPU benchmarks" << std::endl;
+
+    std::string only = argc > 1 ? argv[1] : "";
+    for (const Benchmark& benchmark : BENCHMARKS) {
+        if ((!only.empty() && only != benchmark.Name) || (benchmark.NeedsContext && !window))
+            continue;
+        std::cout << std::endl << "==== " << benchmark.Name << " ====" << std::endl;
+        benchmark.Run();
+    }
+
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "IndexData.h"
+#include "StreamBuffer.h"
+
+
+struct BatchVertex {
+    float Position[3];
+    uint32_t Color;         // RGBA8
+    float TexCoord[2];
+    float TexIndex;         // texture slot of the batch, 0 is plain white
+};
+
+/**
+ * @brief collects 2D quads and triangles with per vertex color in a CPU 
+ * staging buffer and draws them with one glDrawElements per batch.
+ * 
+ * The index buffer is built once: quad i uses vertices 4i .. 4i+3 as 
+ * (0, 1, 2, 2, 3, 0), triangles are stored as quads with the last vertex 
+ * repeated (the second triangle is degenerate). A batch is flushed when it 
+ * is full or when it runs out of texture slots.
+ */
+class BatchRenderer2D {
+public:
+    static const uint32_t MaxTextureSlots = 16;
+
+    struct Stats {
+        uint32_t DrawCalls;
+        uint32_t Quads;     // triangles included
+    };
+
+    /**
+     * @param maxQuads per batch, at most 16384 so the indices fit 16 bits
+     */
+    BatchRenderer2D(uint32_t maxQuads = 10000);
+    ~BatchRenderer2D();
+
+    BatchRenderer2D(const BatchRenderer2D&) = delete;
+    BatchRenderer2D& operator=(const BatchRenderer2D&) = delete;
+
+    void Begin();
+    void End();
+
+    void DrawQuad(float x, float y, float width, float height, const float color[4]);
+    void DrawQuad(float x, float y, float width, float height, GLuint texture, 
+        const float tint[4]);
+    void DrawTriangle(const float p0[2], const float p1[2], const float p2[2], const float color[4]);
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    void Flush();
+    float TextureSlot(GLuint texture);
+    void PushVertex(float x, float y, uint32_t color, float u, float v, float slot);
+
+    uint32_t m_MaxQuads;
+    GLuint m_VAO, m_IBO, m_WhiteTexture, m_Program;
+    IndexData m_QuadIndices;
+    StreamBuffer m_Stream;
+
+    std::vector<BatchVertex> m_Staging;
+    GLuint m_Textures[MaxTextureSlots];
+    uint32_t m_TextureCount;
+    Stats m_Stats;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+
+/**
+ * @brief buddy allocator handing out (offset, size) ranges of a big GPU 
+ * buffer. It only does the bookkeeping, no memory is touched: the units are 
+ * whatever the caller decides (bytes, vertices...).
+ * 
+ * The range [0, capacity) is split in power of two blocks, every block of 
+ * size s is aligned to s, freeing a block merges it back with its buddy.
+ */
+class BuddyAllocator {
+public:
+    static const uint32_t InvalidOffset = 0xFFFFFFFF;
+
+    struct Move {
+        uint32_t From;
+        uint32_t To;
+        uint32_t Size;
+    };
+
+    /**
+     * @param capacity rounded up to minBlockSize * 2^n
+     * @param minBlockSize smallest block handed out, power of two
+     */
+    BuddyAllocator(uint32_t capacity, uint32_t minBlockSize);
+
+    /**
+     * @return offset of a block of at least size units, InvalidOffset when 
+     * there is no room
+     */
+    uint32_t Allocate(uint32_t size);
+    void Free(uint32_t offset);
+
+    /**
+     * @brief incremental defragmentation: moves at most maxMoves allocations, 
+     * starting from the highest, into free blocks with a lower offset.
+     * The caller has to copy the data (glCopyBufferSubData) and patch the 
+     * offsets it keeps for every returned Move.
+     */
+    std::vector<Move> Defragment(uint32_t maxMoves);
+
+    uint32_t GetBlockSize(uint32_t offset) const;
+    uint32_t GetCapacity() const { return m_MinBlockSize << m_MaxOrder; }
+    uint32_t GetUsed() const { return m_Used; }
+    uint32_t GetAllocationCount() const { return (uint32_t)m_Allocated.size(); }
+    // highest used offset + 1, what is left above it is contiguous free space
+    uint32_t GetHighWatermark() const;
+
+private:
+    uint32_t OrderFor(uint32_t size) const;
+    uint32_t AllocateOrder(uint32_t order, bool lowestAddress);
+    uint32_t BlockSize(uint32_t order) const { return m_MinBlockSize << order; }
+
+    uint32_t m_MinBlockSize;
+    uint32_t m_MaxOrder;
+    uint32_t m_Used;
+    std::vector<std::set<uint32_t>> m_FreeLists;    // per order, sorted offsets
+    std::map<uint32_t, uint32_t> m_Allocated;       // offset -> order
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Frustum.h"
+#include "VectorMath.h"
+
+
+/**
+ * @brief dynamic bounding volume hierarchy, one object per leaf.
+ * 
+ * - Build() makes the whole tree top down with a binned SAH (surface area 
+ *   heuristic), for scenes known at load
+ * - Insert() walks down towards the sibling that adds the least area to 
+ *   the tree (the SAH cost, as in Box2D), Remove() collapses the parent
+ * - Update() moves a leaf, its ancestors are refitted right away or, after 
+ *   many moves, all at once with Refit()
+ * 
+ * Culling and picking visit only the branches they need, subtrees fully 
+ * inside the frustum are taken without testing their leaves.
+ */
+class Bvh {
+public:
+    static const uint32_t Null = 0xFFFFFFFF;
+
+    Bvh() : m_Root(Null), m_FreeList(Null), m_LeafCount(0) {}
+
+    /**
+     * @brief replace the tree with count objects, leaf i holds userData[i] 
+     * (or i when userData is null)
+     * @param proxies if not null, receives the leaf of each object
+     */
+    void Build(const Aabb* bounds, size_t count, const uint32_t* userData = nullptr, 
+        uint32_t* proxies = nullptr);
+    void Clear();
+
+    /**
+     * @return the leaf, to Update() or Remove() the object later
+     */
+    uint32_t Insert(const Aabb& bounds, uint32_t userData);
+    void Remove(uint32_t proxy);
+
+    /**
+     * @param refit false to only move the leaf, call Refit() once every 
+     * object has moved
+     */
+    void Update(uint32_t proxy, const Aabb& bounds, bool refit = true);
+    void Refit();
+
+    /**
+     * @param visible receives the user data of the leaves touching the frustum
+     */
+    void Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+    /**
+     * @brief closest leaf box hit by the ray origin + t * direction, t in 
+     * [0, maxDistance]
+     * @param distance if not null, the t of the hit
+     * @return the user data of the leaf, Null on a miss
+     */
+    uint32_t Raycast(const float origin[3], const float direction[3], float maxDistance, 
+        float* distance = nullptr) const;
+
+    uint32_t GetUserData(uint32_t proxy) const { return m_Nodes[proxy].UserData; }
+    const Aabb& GetBounds(uint32_t proxy) const { return m_Nodes[proxy].Bounds; }
+    size_t GetLeafCount() const { return m_LeafCount; }
+    uint32_t GetHeight() const;
+
+    /**
+     * @brief SAH cost of the tree, the sum of the internal nodes areas over 
+     * the root area: lower is faster to query
+     */
+    float GetCost() const;
+
+private:
+    struct Node {
+        Aabb Bounds;
+        uint32_t Parent;
+        uint32_t Children[2];
+        uint32_t UserData;      // next free node when on the free list
+
+        bool IsLeaf() const { return Children[0] == Null; }
+    };
+
+    uint32_t AllocateNode();
+    void FreeNode(uint32_t node);
+    uint32_t BuildRecursive(uint32_t* leaves, const float* centroids, size_t count, uint32_t parent);
+    void RefitAncestors(uint32_t node);
+
+    std::vector<Node> m_Nodes;
+    uint32_t m_Root;
+    uint32_t m_FreeList;
+    size_t m_LeafCount;
+};
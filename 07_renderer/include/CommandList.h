@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "Debug.h"
+#include "JobSystem.h"
+#include "RenderQueue.h"
+
+
+/**
+ * @brief what a replay did, and the bindings it tracks to skip the
+ * redundant ones (a program or VAO already bound)
+ */
+struct ReplayState {
+    static const GLuint Unknown = 0xFFFFFFFF;
+
+    GLuint Program;
+    GLuint VAO;
+    uint32_t Commands;
+    uint32_t Draws;
+    uint32_t SkippedBinds;
+
+    ReplayState() : Program(Unknown), VAO(Unknown), Commands(0), Draws(0), SkippedBinds(0) {}
+};
+
+/**
+ * @brief draw and state commands recorded without GL, replayed later by the
+ * thread owning the context.
+ *
+ * The commands are small PODs (8 to 72 bytes) appended one after the other
+ * in a single buffer, no allocation once it has grown to the size of a
+ * frame. Packet() starts a group of commands with a sort key (a
+ * DrawKey::Encode() for instance): CommandLists replays the packets of all
+ * its lists in key order, so a packet binds everything it needs (the binds
+ * already done by the previous packet are skipped at replay).
+ */
+class CommandList {
+public:
+    /**
+     * @param reserve bytes, grows when needed
+     */
+    explicit CommandList(size_t reserve = 64 * 1024);
+
+    /**
+     * @brief drop every command, back to a single packet with key 0
+     */
+    void Reset();
+
+    /**
+     * @brief the commands recorded from now on go to a new packet
+     */
+    void Packet(uint64_t key) { m_Packets.push_back({ key, (uint32_t)m_Used }); }
+
+    void UseProgram(GLuint program) { Push(UseProgramCommand{ USE_PROGRAM, program }); }
+    void BindVertexArray(GLuint vao) { Push(BindVertexArrayCommand{ BIND_VERTEX_ARRAY, vao }); }
+    void BindTexture(GLuint unit, GLenum target, GLuint texture) {
+        Push(BindTextureCommand{ BIND_TEXTURE, unit, target, texture });
+    }
+    void Uniform1i(GLint location, GLint value) { Push(Uniform1iCommand{ UNIFORM_1I, location, value }); }
+    void Uniform4f(GLint location, float x, float y, float z, float w) {
+        Push(Uniform4fCommand{ UNIFORM_4F, location, { x, y, z, w } });
+    }
+    void UniformMatrix4(GLint location, const float matrix[16]) {
+        UniformMatrix4Command command = { UNIFORM_MATRIX_4, location, {} };
+        memcpy(command.Matrix, matrix, sizeof(command.Matrix));
+        Push(command);
+    }
+    void DrawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instances = 1) {
+        Push(DrawArraysCommand{ DRAW_ARRAYS, mode, first, count, instances });
+    }
+    /**
+     * @param offset in bytes inside the index buffer of the bound VAO
+     */
+    void DrawElements(GLenum mode, GLsizei count, GLenum indexType, GLintptr offset, GLint baseVertex = 0,
+        GLsizei instances = 1) {
+        Push(DrawElementsCommand{ DRAW_ELEMENTS, mode, count, indexType, baseVertex, instances, (uint64_t)offset });
+    }
+
+    /**
+     * @brief issue the GL calls of the commands in [begin, end), in 8 byte
+     * words (see GetPackets()). GL errors are left for the caller to check.
+     */
+    void Execute(size_t begin, size_t end, ReplayState& state) const;
+    void Execute(ReplayState& state) const { Execute(0, m_Used, state); }
+
+    struct PacketStart {
+        uint64_t Key;
+        uint32_t Begin;     // in 8 byte words, a packet ends where the next begins
+    };
+    const std::vector<PacketStart>& GetPackets() const { return m_Packets; }
+
+    size_t GetSize() const { return m_Used; }
+    uint32_t GetCommandCount() const { return m_CommandCount; }
+
+private:
+    enum CommandType : uint32_t {
+        USE_PROGRAM, BIND_VERTEX_ARRAY, BIND_TEXTURE, UNIFORM_1I, UNIFORM_4F, UNIFORM_MATRIX_4,
+        DRAW_ARRAYS, DRAW_ELEMENTS
+    };
+
+    // the type comes first, the replay reads it to know the rest
+    struct alignas(8) UseProgramCommand { CommandType Type; GLuint Program; };
+    struct alignas(8) BindVertexArrayCommand { CommandType Type; GLuint VAO; };
+    struct alignas(8) BindTextureCommand { CommandType Type; GLuint Unit; GLenum Target; GLuint Texture; };
+    struct alignas(8) Uniform1iCommand { CommandType Type; GLint Location; GLint Value; };
+    struct alignas(8) Uniform4fCommand { CommandType Type; GLint Location; float Value[4]; };
+    struct alignas(8) UniformMatrix4Command { CommandType Type; GLint Location; float Matrix[16]; };
+    struct alignas(8) DrawArraysCommand { CommandType Type; GLenum Mode; GLint First; GLsizei Count; GLsizei Instances; };
+    struct alignas(8) DrawElementsCommand {
+        CommandType Type; GLenum Mode; GLsizei Count; GLenum IndexType; GLint BaseVertex; GLsizei Instances; uint64_t Offset;
+    };
+
+    template<typename Command>
+    void Push(const Command& command) {
+        static const size_t words = sizeof(Command) / sizeof(uint64_t);
+        if (m_Used + words > m_Storage.size())
+            m_Storage.resize(std::max(m_Storage.size() * 2, m_Used + words));
+        memcpy(&m_Storage[m_Used], &command, sizeof(Command));
+        m_Used += words;
+        m_CommandCount++;
+    }
+
+    std::vector<uint64_t> m_Storage;    // its size is the capacity, m_Used words are recorded
+    size_t m_Used;
+    uint32_t m_CommandCount;
+    std::vector<PacketStart> m_Packets;
+};
+
+/**
+ * @brief a CommandList per thread of the job system: the jobs record into
+ * GetLocal() without any lock, the render thread replays every list in one
+ * pass with Execute().
+ */
+class CommandLists {
+public:
+    explicit CommandLists(JobSystem& jobs = JobSystem::Get());
+
+    void Reset();
+
+    /**
+     * @brief the list of the calling thread, which must be part of the job
+     * system
+     */
+    CommandList& GetLocal();
+
+    /**
+     * @brief replay the lists, leaves the last program and VAO bound
+     * @param sort by packet key, otherwise list after list (recording order
+     * of each thread)
+     */
+    ReplayState Execute(bool sort = true);
+
+    size_t GetCount() const { return m_Lists.size(); }
+    const CommandList& Get(size_t index) const { return *m_Lists[index]; }
+
+private:
+    struct Span {
+        uint32_t List;
+        uint32_t Begin;
+        uint32_t End;
+    };
+
+    JobSystem& m_Jobs;
+    // separate allocations: the threads don't write the same cache lines
+    std::vector<std::unique_ptr<CommandList>> m_Lists;
+    RenderQueue m_Queue;
+    std::vector<Span> m_Spans;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+// GLEW
+#ifndef GLEW_STATIC
+#define GLEW_STATIC
+#endif
+#include <GL/glew.h>
+
+
+#define ASSERT(x) if (!(x)) __builtin_trap();
+#define GLCall(x) GLClearError();\
+    x;\
+    ASSERT(GLLogCall(#x, __FILE__, __LINE__))
+
+
+/**
+ * @brief used to clear all errors
+ * 
+ */
+void GLClearError();
+
+/**
+ * @brief used to print all errors
+ * 
+ */
+bool GLLogCall(const char* function, const char* file, int line);
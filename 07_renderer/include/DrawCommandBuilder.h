@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "StreamBuffer.h"
+
+
+/**
+ * @brief layout fixed by GL for glMultiDrawElementsIndirect
+ */
+struct DrawElementsIndirectCommand {
+    GLuint Count;
+    GLuint InstanceCount;
+    GLuint FirstIndex;      // in indices, not bytes
+    GLint BaseVertex;
+    GLuint BaseInstance;
+};
+
+/**
+ * @brief records the draws of many meshes sharing one VAO and submits them 
+ * in a single call.
+ * 
+ * With GL 4.3 (or GL_ARB_multi_draw_indirect) the commands are streamed in 
+ * a GL_DRAW_INDIRECT_BUFFER and drawn with glMultiDrawElementsIndirect, on 
+ * GL 4.1 (macOS) they go to glMultiDrawElementsBaseVertex. A multi draw has 
+ * a single index type: commands are grouped by type, one call per group.
+ */
+class DrawCommandBuilder {
+public:
+    /**
+     * @param maxCommands most commands submitted in a frame
+     */
+    DrawCommandBuilder(uint32_t maxCommands = 4096);
+
+    void Reset();
+
+    /**
+     * @param indexOffset in bytes inside the bound index buffer, aligned to 
+     * the index size
+     * @param baseInstance only honored by the indirect path
+     */
+    void Add(GLsizei count, GLenum indexType, GLintptr indexOffset, GLint baseVertex, 
+        GLuint instanceCount = 1, GLuint baseInstance = 0);
+
+    /**
+     * @brief draw everything recorded since Reset() with the bound VAO
+     * @return the number of GL draw calls issued
+     */
+    uint32_t Submit(GLenum mode = GL_TRIANGLES);
+
+    uint32_t GetCommandCount() const;
+    bool IsIndirect() const { return m_Indirect; }
+
+private:
+    static int TypeIndex(GLenum type);
+
+    bool m_Indirect;
+    std::unique_ptr<StreamBuffer> m_Stream;   // only with indirect draws
+    std::vector<DrawElementsIndirectCommand> m_Commands[3]; // ubyte, ushort, uint
+};
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Debug.h"
+#include "Parallel.h"
+
+
+static const uint32_t ECS_MAX_COMPONENTS = 64;
+static const size_t ECS_CHUNK_SIZE = 16 * 1024;
+
+// bit i set when the component with id i is there
+typedef uint64_t ComponentMask;
+
+struct Entity {
+    uint32_t Index;
+    uint32_t Generation;    // bumped when the index is reused
+
+    bool operator==(const Entity& other) const { return Index == other.Index && Generation == other.Generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief component types get an id on first use. Components are plain data
+ * (trivially copyable): chunks move them around with memcpy
+ */
+class ComponentRegistry {
+public:
+    struct Info {
+        uint32_t Size;
+        uint32_t Alignment;
+    };
+
+    template<typename T>
+    static uint32_t GetId() {
+        static_assert(std::is_trivially_copyable<T>::value, "components must be trivially copyable");
+        static const uint32_t id = Register(sizeof(T), alignof(T));
+        return id;
+    }
+
+    template<typename... Ts>
+    static ComponentMask GetMask() { return (ComponentMask(0) | ... | (ComponentMask(1) << GetId<Ts>())); }
+
+    static const Info& GetInfo(uint32_t id);
+
+private:
+    static uint32_t Register(size_t size, size_t alignment);
+};
+
+/**
+ * @brief every entity with the same set of components lives in the same
+ * archetype. Its storage is a list of fixed size chunks (ECS_CHUNK_SIZE),
+ * SoA inside a chunk: the entities array then one array per component, each
+ * on its own cache line. Rows are kept packed: removing one moves the last
+ * row of the last chunk in its place.
+ */
+class Archetype {
+public:
+    struct Chunk {
+        uint8_t* Data;
+        uint32_t Count;
+    };
+
+    Archetype(ComponentMask mask);
+    ~Archetype();
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    /**
+     * @brief append a row, components left uninitialized
+     * @param chunk, row where it is
+     */
+    void AddRow(Entity entity, uint32_t& chunk, uint32_t& row);
+
+    /**
+     * @brief remove a row, filled with the last row of the archetype
+     * @return the entity moved in the hole, or the removed one if it was last
+     */
+    Entity RemoveRow(uint32_t chunk, uint32_t row);
+
+    void* GetComponent(uint32_t id, uint32_t chunk, uint32_t row) {
+        return m_Chunks[chunk].Data + m_Offsets[id] + (size_t)row * ComponentRegistry::GetInfo(id).Size;
+    }
+
+    template<typename T>
+    T* GetArray(const Chunk& chunk) const { return (T*)(chunk.Data + m_Offsets[ComponentRegistry::GetId<T>()]); }
+    Entity* GetEntities(const Chunk& chunk) const { return (Entity*)chunk.Data; }
+
+    ComponentMask GetMask() const { return m_Mask; }
+    const std::vector<uint32_t>& GetComponents() const { return m_Components; }
+    uint32_t GetCapacity() const { return m_Capacity; }
+    const std::vector<Chunk>& GetChunks() const { return m_Chunks; }
+
+private:
+    ComponentMask m_Mask;
+    std::vector<uint32_t> m_Components;
+    uint32_t m_Offsets[ECS_MAX_COMPONENTS];
+    uint32_t m_Capacity;
+    size_t m_ChunkSize;
+    std::vector<Chunk> m_Chunks;
+};
+
+/**
+ * @brief entities and their components, stored by archetype.
+ *
+ * Queries (Each(), EachChunk(), ParallelEach()) walk the chunks of every
+ * archetype having at least the asked components, linearly through the
+ * arrays. Don't create, destroy or change the components of entities while
+ * iterating: it moves rows around.
+ */
+class World {
+public:
+    World() : m_EntityCount(0) {}
+
+    template<typename... Ts>
+    Entity Create(const Ts&... components) {
+        Location location;
+        Entity entity = CreateEntity(ComponentRegistry::GetMask<Ts...>(), location);
+        Archetype& archetype = *m_Archetypes[location.Archetype];
+        ((*(Ts*)archetype.GetComponent(ComponentRegistry::GetId<Ts>(), location.Chunk, location.Row) = components), ...);
+        return entity;
+    }
+
+    void Destroy(Entity entity);
+
+    bool IsAlive(Entity entity) const {
+        return entity.Index < m_Locations.size() && m_Locations[entity.Index].Generation == entity.Generation &&
+            m_Locations[entity.Index].Archetype != Dead;
+    }
+
+    /**
+     * @brief add or overwrite a component, adding moves the entity to
+     * another archetype
+     */
+    template<typename T>
+    void Add(Entity entity, const T& component) {
+        uint32_t id = ComponentRegistry::GetId<T>();
+        ASSERT(IsAlive(entity));
+        Location& location = m_Locations[entity.Index];
+        if (!(m_Archetypes[location.Archetype]->GetMask() & (ComponentMask(1) << id)))
+            Move(entity, m_Archetypes[location.Archetype]->GetMask() | (ComponentMask(1) << id));
+        *(T*)m_Archetypes[location.Archetype]->GetComponent(id, location.Chunk, location.Row) = component;
+    }
+
+    template<typename T>
+    void Remove(Entity entity) {
+        ComponentMask bit = ComponentMask(1) << ComponentRegistry::GetId<T>();
+        ASSERT(IsAlive(entity));
+        ComponentMask mask = m_Archetypes[m_Locations[entity.Index].Archetype]->GetMask();
+        if (mask & bit)
+            Move(entity, mask & ~bit);
+    }
+
+    /**
+     * @return null when the entity doesn't have the component, valid until
+     * the next structural change
+     */
+    template<typename T>
+    T* Get(Entity entity) {
+        uint32_t id = ComponentRegistry::GetId<T>();
+        if (!IsAlive(entity))
+            return nullptr;
+        const Location& location = m_Locations[entity.Index];
+        Archetype& archetype = *m_Archetypes[location.Archetype];
+        if (!(archetype.GetMask() & (ComponentMask(1) << id)))
+            return nullptr;
+        return (T*)archetype.GetComponent(id, location.Chunk, location.Row);
+    }
+
+    template<typename T>
+    bool Has(Entity entity) const {
+        return IsAlive(entity) && (m_Archetypes[m_Locations[entity.Index].Archetype]->GetMask() &
+            (ComponentMask(1) << ComponentRegistry::GetId<T>()));
+    }
+
+    /**
+     * @brief fn(count, entities, Ts* arrays...) for every chunk with the
+     * components Ts
+     */
+    template<typename... Ts, typename Function>
+    void EachChunk(const Function& fn) {
+        ComponentMask mask = ComponentRegistry::GetMask<Ts...>();
+        for (const std::unique_ptr<Archetype>& archetype : m_Archetypes) {
+            if ((archetype->GetMask() & mask) != mask)
+                continue;
+            for (const Archetype::Chunk& chunk : archetype->GetChunks())
+                fn((size_t)chunk.Count, archetype->GetEntities(chunk), archetype->template GetArray<Ts>(chunk)...);
+        }
+    }
+
+    /**
+     * @brief fn(entity, Ts&... components) for every entity with the
+     * components Ts
+     */
+    template<typename... Ts, typename Function>
+    void Each(const Function& fn) {
+        EachChunk<Ts...>([&fn](size_t count, const Entity* entities, Ts*... arrays) {
+            for (size_t i = 0; i < count; i++)
+                fn(entities[i], arrays[i]...);
+        });
+    }
+
+    /**
+     * @brief Each() with the chunks spread over threads, fn is called
+     * concurrently for different entities
+     * @param maxThreads 0 for one per core
+     */
+    template<typename... Ts, typename Function>
+    void ParallelEach(const Function& fn, unsigned int maxThreads = 0) {
+        ComponentMask mask = ComponentRegistry::GetMask<Ts...>();
+        std::vector<std::pair<Archetype*, const Archetype::Chunk*>> chunks;
+        for (const std::unique_ptr<Archetype>& archetype : m_Archetypes) {
+            if ((archetype->GetMask() & mask) != mask)
+                continue;
+            for (const Archetype::Chunk& chunk : archetype->GetChunks())
+                chunks.push_back({ archetype.get(), &chunk });
+        }
+        ParallelFor(chunks.size(), [&](size_t c) {
+            Archetype& archetype = *chunks[c].first;
+            const Archetype::Chunk& chunk = *chunks[c].second;
+            const Entity* entities = archetype.GetEntities(chunk);
+            auto run = [&](Ts*... arrays) {
+                for (uint32_t i = 0; i < chunk.Count; i++)
+                    fn(entities[i], arrays[i]...);
+            };
+            run(archetype.template GetArray<Ts>(chunk)...);
+        }, maxThreads);
+    }
+
+    size_t GetEntityCount() const { return m_EntityCount; }
+    size_t GetArchetypeCount() const { return m_Archetypes.size(); }
+
+private:
+    static const uint32_t Dead = 0xFFFFFFFF;
+
+    struct Location {
+        uint32_t Archetype;     // Dead when the index is free
+        uint32_t Chunk;
+        uint32_t Row;
+        uint32_t Generation;
+    };
+
+    uint32_t GetArchetype(ComponentMask mask);
+    Entity CreateEntity(ComponentMask mask, Location& location);
+    // to the archetype of mask, keeping the components both have
+    void Move(Entity entity, ComponentMask mask);
+    // after a row removal, fix the location of the entity moved in the hole
+    void Relocate(uint32_t archetype, uint32_t chunk, uint32_t row);
+
+    std::vector<std::unique_ptr<Archetype>> m_Archetypes;
+    std::unordered_map<ComponentMask, uint32_t> m_ArchetypeIndex;
+    std::vector<Location> m_Locations;     // by entity index
+    std::vector<uint32_t> m_FreeIndices;
+    size_t m_EntityCount;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cmath>
+
+#include "VectorMath.h"
+
+
+/**
+ * @brief the 6 planes of a view frustum, normals pointing inside
+ */
+struct Frustum {
+    enum { Left, Right, Bottom, Top, Near, Far };
+    Plane Planes[6];
+
+    /**
+     * @brief planes of a column major (GL) matrix, Gribb & Hartmann. With a 
+     * model view projection the planes are in object space.
+     */
+    static Frustum FromMatrix(const float m[16]) {
+        // row i is m[i], m[4 + i], m[8 + i], m[12 + i]
+        static const int ROW[6] = { 0, 0, 1, 1, 2, 2 };
+        static const float SIGN[6] = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+
+        Frustum frustum;
+        for (int p = 0; p < 6; p++) {
+            int r = ROW[p];
+            float plane[4];
+            for (int c = 0; c < 4; c++)
+                plane[c] = m[c * 4 + 3] + SIGN[p] * m[c * 4 + r];
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            float scale = length > 0.0f ? 1.0f / length : 0.0f;
+            frustum.Planes[p] = { { plane[0] * scale, plane[1] * scale, plane[2] * scale }, plane[3] * scale };
+        }
+        return frustum;
+    }
+
+    /**
+     * @brief false when the sphere is fully outside one plane
+     */
+    bool TestSphere(const float center[3], float radius) const {
+        for (const Plane& plane : Planes) {
+            if (plane.Evaluate(center) < -radius)
+                return false;
+        }
+        return true;
+    }
+};
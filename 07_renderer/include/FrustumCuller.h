@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Frustum.h"
+
+
+/**
+ * @brief frustum culling of many objects at once. The bounds are stored as 
+ * structure of arrays (centers, box half extents, sphere radii), so the 
+ * tests run on 16 (AVX-512), 8 (AVX2) or 4 (SSE) objects per instruction. 
+ * The instruction set is picked at runtime on x86, other CPUs use the 
+ * scalar loop.
+ * 
+ * Cull() writes the indices of the visible objects, in order, ready to 
+ * fill an instance buffer or a DrawCommandBuilder.
+ */
+class FrustumCuller {
+public:
+    enum class Volume { Sphere, Box };
+
+    void Reserve(size_t count);
+    void Clear();
+
+    /**
+     * @brief the bounding sphere is the one of the box
+     * @return the index of the object, the order of Add()
+     */
+    uint32_t Add(const float center[3], const float extents[3]);
+    void Update(uint32_t index, const float center[3], const float extents[3]);
+
+    /**
+     * @param visible the indices of the objects inside (or crossing) the frustum
+     * @param volume spheres are cheaper to test, boxes are tighter
+     * @param maxThreads 0 for one per core
+     * @return visible.size()
+     */
+    size_t Cull(const Frustum& frustum, std::vector<uint32_t>& visible, Volume volume = Volume::Box, 
+        unsigned int maxThreads = 0) const;
+
+    size_t GetCount() const { return m_CenterX.size(); }
+
+    /**
+     * @brief "avx512", "avx2", "sse" or "scalar"
+     */
+    static const char* GetInstructionSet();
+
+private:
+    std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+    std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+    std::vector<float> m_Radius;
+};
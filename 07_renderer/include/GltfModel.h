@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Debug.h"
+#include "MappedFile.h"
+
+
+/**
+ * @brief attribute locations the glTF semantics are bound to, the same 
+ * order as the OBJ loader layout (position, normal, uv)
+ */
+enum GltfLocation : GLuint {
+    GLTF_POSITION = 0,
+    GLTF_NORMAL = 1,
+    GLTF_TEXCOORD_0 = 2,
+    GLTF_COLOR_0 = 3,
+    GLTF_TANGENT = 4,
+};
+
+/**
+ * @brief binary glTF (.glb) meshes, loaded without intermediate copies.
+ * 
+ * The file is mmapped and its BIN chunk goes to the GPU with a single 
+ * glBufferStorage/glBufferData straight from the mapping. Every primitive 
+ * then gets a VAO whose attributes point inside that buffer: the accessor 
+ * component type, count, normalized flag, offset and stride map one to one 
+ * onto glVertexAttribPointer (the glTF component types are the GL enums), 
+ * and the index accessor is drawn from the same buffer bound as 
+ * GL_ELEMENT_ARRAY_BUFFER. No JSON value is ever touched per vertex.
+ */
+class GltfModel {
+public:
+    struct Primitive {
+        GLuint VAO;
+        GLenum Mode;
+        GLsizei Count;          // indices, or vertices when not indexed
+        GLenum IndexType;       // 0 when not indexed
+        GLintptr IndexOffset;
+    };
+
+    GltfModel() : m_Buffer(0) {}
+    ~GltfModel() { Release(); }
+
+    GltfModel(const GltfModel&) = delete;
+    GltfModel& operator=(const GltfModel&) = delete;
+
+    /**
+     * @return false (and prints why) if the file is not a glb we can draw
+     */
+    bool LoadGlb(const std::string& filePath);
+    void Release();
+
+    void Draw() const;
+
+    const std::vector<Primitive>& GetPrimitives() const { return m_Primitives; }
+
+private:
+    GLuint m_Buffer;
+    std::vector<Primitive> m_Primitives;
+};
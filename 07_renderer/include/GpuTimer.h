@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Debug.h"
+
+
+/**
+ * @brief measures the GPU time of the commands between Begin() and End() 
+ * with a GL_TIME_ELAPSED query
+ */
+class GpuTimer {
+public:
+    GpuTimer() { GLCall( glGenQueries(1, &m_Query) ); }
+    ~GpuTimer() { glDeleteQueries(1, &m_Query); }
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void Begin() { GLCall( glBeginQuery(GL_TIME_ELAPSED, m_Query) ); }
+    void End() { GLCall( glEndQuery(GL_TIME_ELAPSED) ); }
+
+    /**
+     * @brief waits for the result, only meant for benchmarks
+     */
+    double GetMilliseconds() const {
+        GLuint64 ns = 0;
+        GLCall( glGetQueryObjectui64v(m_Query, GL_QUERY_RESULT, &ns) );
+        return (double)ns * 1e-6;
+    }
+
+private:
+    GLuint m_Query;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Debug.h"
+
+
+/**
+ * @brief a range of the narrowed index stream that is drawn on its own, 
+ * with indices relative to BaseVertex
+ */
+struct IndexChunk {
+    GLintptr ByteOffset;    // inside IndexData::Bytes
+    GLsizei Count;
+    GLint BaseVertex;
+};
+
+/**
+ * @brief indices converted to the smallest type that can hold them, ready 
+ * for glBufferData and glDrawElements(..., Type, ...)
+ */
+struct IndexData {
+    GLenum Type;
+    GLsizei Count;
+    std::vector<uint8_t> Bytes;
+    // more than one chunk only when a big mesh has been split in 16 bit 
+    // ranges, draw each one with glDrawElementsBaseVertex
+    std::vector<IndexChunk> Chunks;
+};
+
+/**
+ * @brief size in bytes of GL_UNSIGNED_BYTE/SHORT/INT
+ */
+GLsizei GetIndexSize(GLenum type);
+
+/**
+ * @brief pick GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT from 
+ * the biggest index. Triangle lists referencing more than 65536 vertices are 
+ * split in chunks spanning at most 65536 vertices each, drawn with a base 
+ * vertex, when the saved bandwidth is worth the extra draw calls.
+ * 
+ * @param indices the GLuint indices
+ * @param count number of indices
+ * @param triangles true for GL_TRIANGLES lists (only those can be split)
+ */
+IndexData NarrowIndices(const GLuint* indices, uint32_t count, bool triangles = true);
+
+/**
+ * @brief separates the strips of StripifyTriangles(), narrowing turns it 
+ * into the biggest value of the index type (GetRestartIndex())
+ */
+static const GLuint PRIMITIVE_RESTART_INDEX = 0xFFFFFFFF;
+
+/**
+ * @brief 0xFF, 0xFFFF or 0xFFFFFFFF, for glPrimitiveRestartIndex
+ */
+GLuint GetRestartIndex(GLenum type);
+
+/**
+ * @brief convert a triangle list to GL_TRIANGLE_STRIP strips separated by 
+ * PRIMITIVE_RESTART_INDEX. Strips are grown greedily across shared edges, 
+ * keeping the winding, seeds are taken in the order of the list (so a cache 
+ * optimized list stays mostly cache friendly). Degenerate triangles are 
+ * dropped.
+ * 
+ * Draw with:
+ *   glEnable(GL_PRIMITIVE_RESTART);
+ *   glPrimitiveRestartIndex(GetRestartIndex(type));
+ *   glDrawElements(GL_TRIANGLE_STRIP, ...);
+ */
+std::vector<GLuint> StripifyTriangles(const GLuint* indices, uint32_t count);
+
+/**
+ * @brief NarrowIndices() for strips: the type is picked so that its 
+ * biggest value stays free for the restart index, never split in chunks
+ */
+IndexData NarrowStripIndices(const GLuint* indices, uint32_t count);
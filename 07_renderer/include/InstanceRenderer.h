@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+#include "StreamBuffer.h"
+
+
+/**
+ * @brief per instance data: an affine transform (3 rows of a 4x4 matrix, 
+ * the last row is always 0 0 0 1) and a color packed as RGBA8
+ */
+struct InstanceData {
+    float Transform[3][4];
+    uint32_t Color;
+};
+
+/**
+ * @brief draws the same mesh many times with one glDrawElementsInstanced.
+ * 
+ * Instead of a glUniform4f + glDrawElements per object, the instances are 
+ * written in a StreamBuffer and read by the vertex shader through attributes 
+ * with glVertexAttribDivisor(location, 1): 
+ * - locations firstLocation .. firstLocation + 2: the transform rows
+ * - location firstLocation + 3: the color (normalized)
+ * (see res/shaders/Instanced.shader)
+ */
+class InstanceRenderer {
+public:
+    /**
+     * @param vao of the mesh, the instance attributes are added to it
+     * @param firstLocation first free attribute location of the vao
+     * @param maxInstances most instances drawn in a frame (all the Begin() 
+     * calls of the frame together)
+     */
+    InstanceRenderer(GLuint vao, GLuint firstLocation, uint32_t maxInstances);
+
+    /**
+     * @brief reserve room for count instances of this frame
+     * @return where to write them, nullptr when count is 0
+     */
+    InstanceData* Begin(uint32_t count);
+
+    /**
+     * @brief draw the instances written since Begin() with the index buffer 
+     * of the vao
+     * @param indexOffset byte offset of the first index
+     */
+    void Draw(GLsizei indexCount, GLenum indexType, const GLvoid* indexOffset = 0, 
+        GLenum mode = GL_TRIANGLES);
+
+    void EndFrame() { m_Stream.EndFrame(); }
+
+    static uint32_t PackColor(float r, float g, float b, float a);
+
+private:
+    GLuint m_VAO;
+    GLuint m_FirstLocation;
+    StreamBuffer m_Stream;
+    StreamBuffer::Allocation m_Current;
+    uint32_t m_Count;
+};
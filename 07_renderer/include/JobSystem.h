@@ -0,0 +1,214 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief number of threads to use when the caller does not say
+ */
+inline unsigned int GetWorkerCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count ? count : 1;
+}
+
+class JobCounter;
+
+/**
+ * @brief a function and its captures, stored inline: no allocation per job
+ */
+struct Job {
+    static const size_t StorageSize = 64;
+
+    alignas(16) unsigned char Storage[StorageSize];
+    void (*Invoke)(void* storage);
+    void (*Destroy)(void* storage);
+    JobCounter* Counter;
+    std::atomic<bool> Free;     // the ring slot can be reused
+    bool Heap;                  // allocated with new, not in a ring
+
+    Job() : Invoke(nullptr), Destroy(nullptr), Counter(nullptr), Free(true), Heap(false) {}
+};
+
+/**
+ * @brief counts the jobs not finished yet. Wait() on it, or make other jobs
+ * depend on it: they are queued when it drops to zero. A counter can be
+ * reused once it is done, it must outlive its jobs.
+ */
+class JobCounter {
+public:
+    JobCounter() : m_Pending(0) {}
+    // the last job may still be unlocking after the count reached zero
+    ~JobCounter() { std::lock_guard<std::mutex> lock(m_Mutex); }
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_Pending;
+    std::mutex m_Mutex;
+    std::vector<Job*> m_Dependents;
+};
+
+/**
+ * @brief Chase-Lev work stealing deque (the C11 version of Lê et al.). The
+ * owner thread pushes and pops at the bottom (LIFO, hot in cache), the
+ * other threads steal at the top (FIFO, the biggest pieces of work). Fixed
+ * capacity: Push() fails when full.
+ */
+class WorkStealingDeque {
+public:
+    /**
+     * @param capacity power of 2
+     */
+    explicit WorkStealingDeque(size_t capacity);
+
+    bool Push(Job* job);
+    Job* Pop();
+    Job* Steal();
+
+private:
+    alignas(64) std::atomic<int64_t> m_Top;
+    alignas(64) std::atomic<int64_t> m_Bottom;
+    alignas(64) std::unique_ptr<std::atomic<Job*>[]> m_Jobs;
+    int64_t m_Mask;
+};
+
+/**
+ * @brief work stealing scheduler: one deque per thread, idle threads steal
+ * from the others.
+ *
+ * The thread creating the system is slot 0 and works while it waits, the
+ * others are background workers. Threads outside the system may submit
+ * jobs too (through a locked queue) and help in Wait().
+ *
+ * Jobs are small functors (captures up to Job::StorageSize bytes, capture
+ * big things by reference) stored in a per thread ring, without allocation.
+ */
+class JobSystem {
+public:
+    static const size_t RingSize = 4096;
+
+    /**
+     * @param threads including the calling one, 0 for one per core
+     */
+    explicit JobSystem(unsigned int threads = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief queue fn()
+     * @param counter incremented now, decremented when fn returns
+     * @param dependency fn is only queued once this counter is done
+     */
+    template<typename Function>
+    void Run(Function&& fn, JobCounter* counter = nullptr, JobCounter* dependency = nullptr) {
+        typedef typename std::decay<Function>::type Functor;
+        static_assert(sizeof(Functor) <= Job::StorageSize && alignof(Functor) <= 16,
+            "job captures too big, capture by reference");
+
+        Job* job = Allocate();
+        new (job->Storage) Functor(std::forward<Function>(fn));
+        job->Invoke = [](void* storage) { (*(Functor*)storage)(); };
+        job->Destroy = [](void* storage) { ((Functor*)storage)->~Functor(); };
+        job->Counter = counter;
+        if (counter)
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        if (dependency)
+            AddDependent(*dependency, job);
+        else
+            Submit(job);
+    }
+
+    /**
+     * @brief run jobs until the counter is done
+     */
+    void Wait(JobCounter& counter);
+
+    /**
+     * @brief fn(i) for i in [0, count). The range is split in halves until
+     * grain indices are left, the halves are jobs the idle threads steal.
+     */
+    template<typename Function>
+    void ParallelFor(size_t count, size_t grain, const Function& fn) {
+        JobCounter counter;
+        RunRange(0, count, grain ? grain : 1, fn, counter);
+        Wait(counter);
+    }
+
+    unsigned int GetThreadCount() const { return (unsigned int)m_Slots.size(); }
+
+    /**
+     * @brief slot of the calling thread in [0, GetThreadCount()), -1 when it 
+     * isn't part of the system
+     */
+    int GetSlot() const;
+
+    /**
+     * @brief the system shared by the renderer, one thread per core, created
+     * by the first caller (which becomes its slot 0)
+     */
+    static JobSystem& Get();
+
+private:
+    struct Slot {
+        WorkStealingDeque Deque;
+        std::unique_ptr<Job[]> Ring;
+        size_t Next;
+
+        Slot() : Deque(RingSize), Ring(new Job[RingSize]), Next(0) {}
+    };
+
+    template<typename Function>
+    void RunRange(size_t begin, size_t end, size_t grain, const Function& fn, JobCounter& counter) {
+        while (end - begin > grain) {
+            size_t middle = begin + (end - begin) / 2;
+            Run([this, middle, end, grain, &fn, &counter]() { RunRange(middle, end, grain, fn, counter); },
+                &counter);
+            end = middle;
+        }
+        for (size_t i = begin; i < end; i++)
+            fn(i);
+    }
+
+    Job* Allocate();
+    void Submit(Job* job);
+    void AddDependent(JobCounter& dependency, Job* job);
+    Job* Find(int slot);
+    void Execute(Job* job);
+    void WorkerLoop(int slot);
+
+    std::vector<std::unique_ptr<Slot>> m_Slots;
+    std::vector<std::thread> m_Threads;
+
+    // jobs from threads outside the system, or from full deques
+    std::mutex m_SharedMutex;
+    std::deque<Job*> m_Shared;
+    std::atomic<size_t> m_SharedCount;
+
+    // idle workers sleep until something is queued
+    std::mutex m_SleepMutex;
+    std::condition_variable m_Wake;
+    std::atomic<int64_t> m_Queued;
+    std::atomic<int> m_Sleeping;
+    std::atomic<bool> m_Quit;
+
+    // what the creating thread was part of before, restored on destruction
+    const JobSystem* m_PreviousSystem;
+    int m_PreviousSlot;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief minimal JSON document, just what the glTF loader needs: parsed 
+ * once into a tree of values, no writing
+ */
+class JsonValue {
+public:
+    enum class Type {
+        Null, Bool, Number, String, Array, Object
+    };
+
+    JsonValue() : m_Type(Type::Null), m_Number(0.0) {}
+
+    /**
+     * @return false (and prints where) on a syntax error
+     */
+    static bool Parse(const char* text, size_t size, JsonValue& value);
+
+    Type GetType() const { return m_Type; }
+    bool IsNull() const { return m_Type == Type::Null; }
+
+    double AsNumber(double fallback = 0.0) const { return m_Type == Type::Number ? m_Number : fallback; }
+    bool AsBool(bool fallback = false) const { return m_Type == Type::Bool ? m_Number != 0.0 : fallback; }
+    const std::string& AsString() const { return m_String; }
+
+    // arrays
+    size_t GetSize() const { return m_Array.size(); }
+    const JsonValue& operator[](size_t index) const;
+
+    // objects, a missing key gives a null value
+    const JsonValue& operator[](const std::string& key) const;
+    bool Has(const std::string& key) const { return m_Object.count(key) != 0; }
+    const std::map<std::string, JsonValue>& GetMembers() const { return m_Object; }
+
+private:
+    friend class JsonParser;
+
+    Type m_Type;
+    double m_Number;
+    std::string m_String;
+    std::vector<JsonValue> m_Array;
+    std::map<std::string, JsonValue> m_Object;
+};
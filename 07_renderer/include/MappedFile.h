@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+
+/**
+ * @brief read only memory mapping of a whole file (POSIX mmap), the bytes 
+ * are paged in by the OS when touched, nothing is copied
+ */
+class MappedFile {
+public:
+    MappedFile() : m_Data(nullptr), m_Size(0) {}
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @return false (and prints why) if the file can't be mapped
+     */
+    bool Open(const std::string& filePath);
+    void Close();
+
+    const char* GetData() const { return m_Data; }
+    size_t GetSize() const { return m_Size; }
+    bool IsOpen() const { return m_Data != nullptr; }
+
+private:
+    const char* m_Data;
+    size_t m_Size;
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "VertexBufferLayout.h"
+
+
+/**
+ * Binary mesh container (.mesh), made to be mmapped and handed to GL as is.
+ * 
+ *   MeshFileHeader
+ *   MeshFileStream[StreamCount]
+ *   MeshFileLod[LodCount]
+ *   attribute streams, one per attribute, each MESH_FILE_ALIGNMENT aligned
+ *   index stream, MESH_FILE_ALIGNMENT aligned
+ * 
+ * All the values are little endian. The attribute streams are not 
+ * interleaved: a position only pass only fetches the position stream, and 
+ * the streams follow each other so the whole vertex section is one upload.
+ */
+static const uint32_t MESH_FILE_MAGIC = 0x4853454D;    // "MESH"
+static const uint32_t MESH_FILE_VERSION = 1;
+static const uint32_t MESH_FILE_ALIGNMENT = 64;
+
+struct MeshFileHeader {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t VertexCount;
+    uint32_t IndexCount;        // of all the LODs
+    uint32_t IndexType;         // GL_UNSIGNED_BYTE/SHORT/INT
+    uint32_t StreamCount;
+    uint32_t LodCount;
+    uint32_t Reserved;
+    float BoundsMin[3];
+    float BoundsMax[3];
+    float Center[3];            // bounding sphere
+    float Radius;
+    uint64_t IndexOffset;       // bytes from the start of the file
+    uint64_t IndexSize;
+    uint64_t FileSize;
+};
+
+struct MeshFileStream {
+    uint32_t Location;          // attribute location
+    uint32_t Type;              // GL component type
+    uint32_t Count;             // components, the stream is tightly packed
+    uint32_t Normalized;
+    uint64_t Offset;            // bytes from the start of the file
+    uint64_t Size;
+};
+
+/**
+ * @brief a range of the index stream, LOD 0 is the full detail mesh
+ */
+struct MeshFileLod {
+    uint32_t FirstIndex;
+    uint32_t IndexCount;
+    float Error;                // object space, 0 for LOD 0
+    uint32_t Reserved;
+};
+
+/**
+ * @brief write interleaved vertices as a .mesh, split in one stream per 
+ * layout element (attribute location = element index). The first element 
+ * must be the 3 float position, it gives the bounds.
+ * 
+ * @param indices indexCount GLuint indices, narrowed to the smallest type
+ * @param lods ranges of indices, empty for a single LOD with all of them
+ * @return false (and prints why) if the file can't be written
+ */
+bool WriteMeshFile(const std::string& filePath, const void* vertices, uint32_t vertexCount, 
+    const VertexBufferLayout& layout, const GLuint* indices, uint32_t indexCount, 
+    const std::vector<MeshFileLod>& lods = {});
+
+/**
+ * @brief pick a LOD from the size its error projects to on screen: the 
+ * coarsest LOD whose error covers at most threshold pixels. Going to a 
+ * coarser LOD also needs the error under (1 - hysteresis) * threshold, so 
+ * an object at the boundary distance doesn't flicker between two LODs.
+ * 
+ * @param distance from the camera to the bounding sphere center
+ * @param projectionScale pixels per unit at distance 1, 
+ * projection[1][1] * viewportHeight / 2
+ * @param current the LOD drawn last frame
+ */
+unsigned int SelectLod(const std::vector<MeshFileLod>& lods, float distance, float projectionScale, 
+    unsigned int current, float threshold = 1.0f, float hysteresis = 0.25f);
+
+/**
+ * @brief a .mesh file on the GPU. Load() mmaps the file and uploads the 
+ * vertex section and the index section straight from the mapping, one 
+ * buffer each, then the mapping is dropped.
+ */
+class MeshFile {
+public:
+    MeshFile() : m_VAO(0), m_VertexBuffer(0), m_IndexBuffer(0), m_Header() {}
+    ~MeshFile() { Release(); }
+
+    MeshFile(const MeshFile&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+
+    /**
+     * @return false (and prints why) if the file is not a valid .mesh
+     */
+    bool Load(const std::string& filePath);
+    void Release();
+
+    /**
+     * @brief glDrawElements of one LOD range, the VAO is left bound
+     */
+    void Draw(unsigned int lod = 0, GLenum mode = GL_TRIANGLES) const;
+
+    GLuint GetVAO() const { return m_VAO; }
+    const MeshFileHeader& GetHeader() const { return m_Header; }
+    const std::vector<MeshFileLod>& GetLods() const { return m_Lods; }
+
+private:
+    GLuint m_VAO;
+    GLuint m_VertexBuffer;
+    GLuint m_IndexBuffer;
+    MeshFileHeader m_Header;
+    std::vector<MeshFileLod> m_Lods;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "VertexBufferLayout.h"
+
+
+/**
+ * @brief post-transform vertex cache efficiency, simulated with a FIFO
+ * - ACMR: transformed vertices per triangle (0.5 ideal, 3 worst)
+ * - ATVR: transformed vertices per vertex (1 ideal)
+ */
+struct VertexCacheStats {
+    float ACMR;
+    float ATVR;
+};
+
+/**
+ * @brief pre-transform (memory) efficiency: bytes pulled from memory in 
+ * cache lines over the bytes of the vertices actually used (1 ideal)
+ */
+struct VertexFetchStats {
+    size_t BytesFetched;
+    float OverfetchRatio;
+};
+
+struct MeshOptimizationReport {
+    VertexCacheStats CacheBefore, CacheAfter;
+    VertexFetchStats FetchBefore, FetchAfter;
+};
+
+VertexCacheStats AnalyzeVertexCache(const GLuint* indices, size_t indexCount, size_t vertexCount, 
+    unsigned int cacheSize = 16);
+
+VertexFetchStats AnalyzeVertexFetch(const GLuint* indices, size_t indexCount, size_t vertexCount, 
+    size_t vertexSize);
+
+/**
+ * @brief reorder triangles for the post-transform cache (Tipsify, Sander et 
+ * al. 2007): fan around the last vertices while they are still in cache
+ * @param destination indexCount indices, can't alias indices
+ */
+void OptimizeVertexCache(GLuint* destination, const GLuint* indices, size_t indexCount, 
+    size_t vertexCount, unsigned int cacheSize = 16);
+
+/**
+ * @brief reorder clusters of triangles so the outer facing ones are drawn 
+ * first, keeping the cache order inside the clusters. To run after 
+ * OptimizeVertexCache().
+ * @param positions first 3 floats of each vertex, vertexStride bytes apart
+ * @param threshold how much ACMR can degrade to get smaller clusters
+ */
+void OptimizeOverdraw(GLuint* destination, const GLuint* indices, size_t indexCount, 
+    const float* positions, size_t vertexCount, size_t vertexStride, float threshold = 1.05f, 
+    unsigned int cacheSize = 16);
+
+/**
+ * @brief renumber the vertices in the order the indices first use them, so 
+ * the fetches walk memory linearly. Unreferenced vertices are dropped.
+ * @param destination room for vertexCount vertices, can't alias vertices
+ * @param indices remapped in place
+ * @return the number of vertices written
+ */
+size_t OptimizeVertexFetch(void* destination, GLuint* indices, size_t indexCount, 
+    const void* vertices, size_t vertexCount, size_t vertexSize);
+
+/**
+ * @brief the whole pipeline, cache -> overdraw -> fetch, on a mesh whose 
+ * layout starts with a 3 float position. Can run offline or at load.
+ */
+MeshOptimizationReport OptimizeMesh(std::vector<uint8_t>& vertices, std::vector<GLuint>& indices, 
+    const VertexBufferLayout& layout);
+
+void PrintMeshOptimizationReport(const MeshOptimizationReport& report);
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "BuddyAllocator.h"
+#include "DrawCommandBuilder.h"
+#include "IndexData.h"
+#include "VertexBufferLayout.h"
+
+
+/**
+ * @brief packs many meshes in a few large vertex/index buffers instead of a 
+ * VBO/IBO/VAO triple per mesh.
+ * 
+ * The pool is made of pages, each page is a big VBO + IBO with a single VAO. 
+ * Vertices are sub-allocated in units of vertices (so the offset is directly 
+ * the base vertex), indices in bytes, narrowed by NarrowIndices(). Meshes are drawn with 
+ * glDrawElementsBaseVertex, consecutive draws in the same page do not 
+ * rebind the VAO.
+ */
+class MeshPool {
+public:
+    typedef uint32_t MeshHandle;
+    static const MeshHandle InvalidMesh = 0xFFFFFFFF;
+
+    struct MeshInfo {
+        uint32_t Page;
+        GLint BaseVertex;       // first vertex inside the page VBO
+        uint32_t VertexCount;
+        GLintptr IndexOffset;   // bytes inside the page IBO
+        GLsizei IndexCount;
+        GLenum IndexType;       // narrowed to the smallest type that fits
+        std::vector<IndexChunk> Chunks; // one draw each, relative to the above
+    };
+
+    /**
+     * @param layout of the vertices, shared by every mesh of the pool
+     * @param verticesPerPage vertex capacity of a page
+     * @param indicesPerPage index capacity of a page (counted as GLuint)
+     */
+    MeshPool(const VertexBufferLayout& layout, uint32_t verticesPerPage = 1 << 16, 
+        uint32_t indicesPerPage = 1 << 18);
+    ~MeshPool();
+
+    MeshPool(const MeshPool&) = delete;
+    MeshPool& operator=(const MeshPool&) = delete;
+
+    /**
+     * @brief upload a mesh in the pool
+     * @param vertices laid out as described by the pool layout
+     * @return MeshHandle to draw/remove the mesh, InvalidMesh for an empty
+     * mesh (no vertex or no index): Draw(), DrawMulti() and Remove() ignore it
+     */
+    MeshHandle Add(const void* vertices, uint32_t vertexCount, const GLuint* indices, 
+        uint32_t indexCount);
+    void Remove(MeshHandle mesh);
+
+    /**
+     * @brief bind the page VAO (only if needed) and draw the mesh
+     */
+    void Draw(MeshHandle mesh, GLenum mode = GL_TRIANGLES);
+    /**
+     * @brief draw many meshes at once: their commands are recorded in 
+     * builder and submitted with one multi draw per page (and index type)
+     * @return the number of GL draw calls issued
+     */
+    uint32_t DrawMulti(const MeshHandle* meshes, uint32_t count, DrawCommandBuilder& builder, 
+        GLenum mode = GL_TRIANGLES);
+
+    void BindPage(uint32_t page);
+    void Unbind();
+
+    /**
+     * @brief incremental defragmentation, to be called once per frame: moves 
+     * at most maxMoves vertex and index ranges of every page towards the 
+     * beginning of the buffers with glCopyBufferSubData
+     * @return the number of ranges moved
+     */
+    uint32_t Defragment(uint32_t maxMoves = 4);
+
+    const MeshInfo& GetInfo(MeshHandle mesh) const { return m_Meshes[mesh]; }
+    uint32_t GetPageCount() const { return (uint32_t)m_Pages.size(); }
+    GLuint GetPageVAO(uint32_t page) const { return m_Pages[page].VAO; }
+    const VertexBufferLayout& GetLayout() const { return m_Layout; }
+
+private:
+    struct Page {
+        GLuint VAO, VBO, IBO;
+        BuddyAllocator Vertices;
+        BuddyAllocator Indices;
+        // allocation offset -> mesh, to patch meshes moved by Defragment()
+        std::unordered_map<uint32_t, MeshHandle> VertexOwners;
+        std::unordered_map<uint32_t, MeshHandle> IndexOwners;
+    };
+
+    uint32_t CreatePage(uint32_t vertexCapacity, uint32_t indexBytes);
+
+    VertexBufferLayout m_Layout;
+    uint32_t m_VerticesPerPage;
+    uint32_t m_IndexBytesPerPage;
+    std::vector<Page> m_Pages;
+    std::vector<MeshInfo> m_Meshes;
+    std::vector<MeshHandle> m_FreeHandles;
+    uint32_t m_BoundPage;
+};
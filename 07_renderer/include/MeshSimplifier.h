@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "MeshFile.h"
+
+
+/**
+ * @brief quadric error simplification (Garland & Heckbert 1997), by edge 
+ * collapses onto existing vertices: the result indexes the same vertex 
+ * buffer, no vertex is added or moved.
+ * 
+ * Collapses are done in passes, cheapest first, each vertex collapsing at 
+ * most once per pass. Border vertices and vertices on attribute seams (same 
+ * position, different vertex) are locked, collapses that would flip a 
+ * triangle are rejected.
+ * 
+ * @param destination room for indexCount indices, can alias indices
+ * @param positions first 3 floats of each vertex, vertexStride bytes apart
+ * @param targetIndexCount stop once there are this many indices or less
+ * @param targetError stop before a collapse would move the surface further 
+ * than this (object space, RMS distance to the original planes)
+ * @param resultError if not null, the error of the result
+ * @return the number of indices written
+ */
+size_t SimplifyMesh(GLuint* destination, const GLuint* indices, size_t indexCount, 
+    const float* positions, size_t vertexCount, size_t vertexStride, size_t targetIndexCount, 
+    float targetError, float* resultError = nullptr);
+
+/**
+ * @brief LOD chain of a triangle list: each LOD is simplified from the 
+ * previous one down to ratio of its triangles, cache optimized and appended 
+ * to indices. The chain stops early when the simplifier can't remove at 
+ * least 10% more triangles.
+ * 
+ * @param indices LOD 0, the LODs are appended after it
+ * @param maxLods including LOD 0
+ * @return the ranges, LOD 0 first, ready for WriteMeshFile()
+ */
+std::vector<MeshFileLod> GenerateLods(std::vector<GLuint>& indices, const float* positions, 
+    size_t vertexCount, size_t vertexStride, unsigned int maxLods = 4, float ratio = 0.5f, 
+    float maxError = 1e30f);
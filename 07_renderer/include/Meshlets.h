@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "DrawCommandBuilder.h"
+#include "Frustum.h"
+
+
+static const unsigned int MESHLET_MAX_VERTICES = 64;
+static const unsigned int MESHLET_MAX_TRIANGLES = 124;
+
+/**
+ * @brief a small cluster of triangles, a range of the index buffer, with 
+ * what is needed to cull it as a whole:
+ * - a bounding sphere, against the frustum
+ * - a normal cone, the cluster faces away from any camera inside the cone 
+ * behind ConeApex: dot(normalize(ConeApex - camera), ConeAxis) >= ConeCutoff
+ */
+struct Meshlet {
+    float Center[3];
+    float Radius;
+    float ConeApex[3];
+    float ConeCutoff;       // above 1 when the triangles face too many ways to ever be culled
+    float ConeAxis[3];
+    uint32_t FirstIndex;
+    uint32_t TriangleCount;
+    uint32_t VertexCount;
+};
+
+/**
+ * @brief split a triangle list into meshlets, in index order: a meshlet is 
+ * closed when the next triangle would take it over maxVertices unique 
+ * vertices or maxTriangles triangles. Run OptimizeVertexCache() first, its 
+ * order keeps neighbouring triangles together. The indices are not changed.
+ * 
+ * @param positions first 3 floats of each vertex, vertexStride bytes apart
+ */
+std::vector<Meshlet> BuildMeshlets(const GLuint* indices, size_t indexCount, const float* positions, 
+    size_t vertexCount, size_t vertexStride, unsigned int maxVertices = MESHLET_MAX_VERTICES, 
+    unsigned int maxTriangles = MESHLET_MAX_TRIANGLES);
+
+/**
+ * @brief frustum and backface culling of every meshlet, in parallel.
+ * Frustum and camera must be in the space of the mesh: build the frustum 
+ * from the model view projection and move the camera by the inverse model.
+ * 
+ * @param visible the indices of the visible meshlets, in order
+ * @param maxThreads 0 for one per core
+ * @return visible.size()
+ */
+size_t CullMeshlets(const std::vector<Meshlet>& meshlets, const Frustum& frustum, 
+    const float cameraPosition[3], std::vector<uint32_t>& visible, unsigned int maxThreads = 0);
+
+/**
+ * @brief one command per run of consecutive visible meshlets, they are 
+ * contiguous in the index buffer
+ * @param indexOffset bytes from the start of the index buffer to the mesh
+ * @return the number of commands added
+ */
+uint32_t AddMeshletDraws(DrawCommandBuilder& builder, const std::vector<Meshlet>& meshlets, 
+    const std::vector<uint32_t>& visible, GLenum indexType, GLintptr indexOffset = 0, GLint baseVertex = 0);
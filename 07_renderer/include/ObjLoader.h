@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "VertexBufferLayout.h"
+
+
+/**
+ * @brief interleaved vertices (position, then normal and uv when the file 
+ * has them) and triangle indices, ready for glBufferData
+ */
+struct ObjMesh {
+    std::vector<float> Vertices;
+    std::vector<GLuint> Indices;
+    VertexBufferLayout Layout;
+    uint32_t VertexCount;
+    bool HasNormals;
+    bool HasTexCoords;
+};
+
+/**
+ * @brief Wavefront OBJ loader (v, vt, vn and f, polygons are fanned into 
+ * triangles, everything else is skipped).
+ * 
+ * The file is mmapped and split in chunks at line boundaries, the chunks 
+ * are parsed in parallel with std::from_chars. Then the v/vt/vn triplets of 
+ * the faces are deduplicated through an open addressing hash map and the 
+ * unique vertices are gathered, again in parallel, into one interleaved 
+ * buffer.
+ * 
+ * @param maxThreads 0 for one per core
+ * @return false (and prints why) if the file can't be read
+ */
+bool LoadObj(const std::string& filePath, ObjMesh& mesh, unsigned int maxThreads = 0);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Debug.h"
+
+
+/**
+ * @brief hardware occlusion culling: the caller draws a cheap proxy (the 
+ * bounding box) of an object inside a query, then uses the answer in one of 
+ * two ways:
+ * 
+ * - conditional rendering: the real draw goes between 
+ *   BeginConditionalRender()/EndConditionalRender(), the GPU skips it by 
+ *   itself when no sample of the proxy passed. The CPU never waits, but 
+ *   still records the draw.
+ * - latent results: IsVisible() answers with the newest query result that 
+ *   is already available (usually one or two frames old), nothing is ever 
+ *   read back with a stall and hidden objects are not even recorded. An 
+ *   object coming into view shows up a frame or two late.
+ * 
+ * The queries are GL_ANY_SAMPLES_PASSED_CONSERVATIVE when GL 4.3 or 
+ * GL_ARB_ES3_compatibility has it, GL_ANY_SAMPLES_PASSED otherwise (the 4.1 
+ * context on macOS). A query per object and per frame in flight.
+ */
+class OcclusionQueries {
+public:
+    /**
+     * @param framesInFlight how many frames a result may take to come back
+     */
+    OcclusionQueries(uint32_t maxObjects, uint32_t framesInFlight = 3);
+    ~OcclusionQueries();
+
+    OcclusionQueries(const OcclusionQueries&) = delete;
+    OcclusionQueries& operator=(const OcclusionQueries&) = delete;
+
+    /**
+     * @brief collect the results that came back, without waiting, then 
+     * move to the queries of the new frame
+     */
+    void BeginFrame();
+
+    /**
+     * @brief no color nor depth writes while the proxies are drawn, the 
+     * depth test stays on
+     */
+    static void BeginProxies();
+    static void EndProxies();
+
+    void BeginQuery(uint32_t object);
+    void EndQuery();
+
+    /**
+     * @brief draws until EndConditionalRender() only count if the query of 
+     * the object issued this frame passed (GL_QUERY_NO_WAIT: when the result 
+     * is late the GPU draws anyway)
+     */
+    void BeginConditionalRender(uint32_t object);
+    static void EndConditionalRender();
+
+    /**
+     * @brief the newest available result, true until the first one
+     */
+    bool IsVisible(uint32_t object) const { return m_Visible[object]; }
+
+    GLenum GetTarget() const { return m_Target; }
+
+private:
+    GLuint& Query(uint32_t slot, uint32_t object) { return m_Queries[slot * m_MaxObjects + object]; }
+
+    GLenum m_Target;
+    uint32_t m_MaxObjects;
+    uint32_t m_Frames;
+    uint32_t m_Slot;
+    uint32_t m_Current;     // object of the open query
+    std::vector<GLuint> m_Queries;
+    std::vector<uint8_t> m_Pending;
+    std::vector<bool> m_Visible;
+};
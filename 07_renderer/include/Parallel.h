@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+#include "JobSystem.h"
+
+
+/**
+ * @brief call fn(i) for i in [0, count) spread over the threads of the job 
+ * system, the calling thread takes part. Returns when every call is done.
+ * 
+ * threads - 1 jobs pull indices from a shared counter with the caller, so 
+ * maxThreads still caps the parallelism (the benchmarks scale it).
+ * @param maxThreads 0 for one per core
+ */
+template<typename Function>
+void ParallelFor(size_t count, const Function& fn, unsigned int maxThreads = 0) {
+    JobSystem& jobs = JobSystem::Get();
+    unsigned int threads = maxThreads ? std::min(maxThreads, jobs.GetThreadCount()) : jobs.GetThreadCount();
+    threads = (unsigned int)std::min<size_t>(threads, count);
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; i++)
+            fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t i = next++; i < count; i = next++)
+            fn(i);
+    };
+
+    JobCounter counter;
+    for (unsigned int t = 1; t < threads; t++)
+        jobs.Run(work, &counter);
+    work();
+    jobs.Wait(counter);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * @brief what decides the order of a draw, packed in 64 bits by Encode():
+ * 
+ *   opaque:      layer:4 | 0 | program:10 | material:12 | vao:10 | depth:24 | 0:3
+ *   translucent: layer:4 | 1 | ~depth:24  | program:10  | material:12 | vao:10 | 0:3
+ * 
+ * Opaque draws are grouped by state then sorted front to back, translucent 
+ * ones are sorted back to front first (blending needs it) and grouped by 
+ * state only among equal depths.
+ */
+struct DrawKey {
+    uint8_t Layer;          // 0..15, drawn in increasing order
+    bool Translucent;
+    uint16_t Program;       // 0..1023
+    uint16_t Material;      // 0..4095
+    uint16_t VAO;           // 0..1023
+    float Depth;            // view depth normalized to [0, 1]
+
+    uint64_t Encode() const;
+    static DrawKey Decode(uint64_t key);
+};
+
+/**
+ * @brief state changes needed to draw the queue in its current order
+ */
+struct BindStats {
+    uint32_t Programs;
+    uint32_t Materials;
+    uint32_t VAOs;
+};
+
+/**
+ * @brief the draws of a frame, sorted by key before submission with an LSD 
+ * radix sort (8 bits per pass, passes where all keys share the digit are 
+ * skipped)
+ */
+class RenderQueue {
+public:
+    struct Item {
+        uint64_t Key;
+        uint32_t Payload;   // what to draw, e.g. index in the frame's draw list
+    };
+
+    void Clear() { m_Items.clear(); }
+    void Reserve(size_t count) { m_Items.reserve(count); m_Scratch.reserve(count); }
+
+    void Push(const DrawKey& key, uint32_t payload) { m_Items.push_back({key.Encode(), payload}); }
+    void Push(uint64_t key, uint32_t payload) { m_Items.push_back({key, payload}); }
+
+    void Sort();
+
+    BindStats CountBinds() const;
+
+    const std::vector<Item>& GetItems() const { return m_Items; }
+    size_t GetSize() const { return m_Items.size(); }
+
+    /**
+     * @brief LSD radix sort of items by key, stable
+     * @param scratch room for count items
+     */
+    static void RadixSort(Item* items, Item* scratch, size_t count);
+
+private:
+    std::vector<Item> m_Items;
+    std::vector<Item> m_Scratch;
+};
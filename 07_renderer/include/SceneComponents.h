@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+#include "InstanceRenderer.h"
+#include "MeshPool.h"
+
+
+/**
+ * @brief the components the renderer reads from the World (see Ecs.h)
+ */
+
+/**
+ * @brief translation and scale, no rotation yet
+ */
+struct TransformComponent {
+    float Position[3];
+    float Scale[3];
+
+    /**
+     * @brief the 3 rows of the affine matrix, as InstanceData wants them
+     * @param offset added to the translation (e.g. minus the camera)
+     */
+    void ToRows(float rows[3][4], const float offset[3] = nullptr) const {
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++)
+                rows[r][c] = r == c ? Scale[r] : 0.0f;
+            rows[r][3] = Position[r] + (offset ? offset[r] : 0.0f);
+        }
+    }
+
+    /**
+     * @brief column major (GL) 4x4 matrix, e.g. a TransformHierarchy local
+     */
+    void ToMatrix(float m[16]) const {
+        for (int i = 0; i < 16; i++)
+            m[i] = i % 5 == 0 ? 1.0f : 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            m[axis * 5] = Scale[axis];
+            m[12 + axis] = Position[axis];
+        }
+    }
+};
+
+/**
+ * @brief a mesh of the MeshPool
+ */
+struct MeshComponent {
+    MeshPool::MeshHandle Mesh;
+};
+
+/**
+ * @brief program and material as in DrawKey, plus the instance color
+ */
+struct MaterialComponent {
+    uint16_t Program;
+    uint16_t Material;
+    uint32_t Color;     // InstanceRenderer::PackColor()
+};
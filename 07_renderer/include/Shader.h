@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+
+#include "Debug.h"
+
+
+struct ShaderProgramSource {
+    std::string VertexShader;
+    std::string FragmentShader;
+};
+
+/**
+ * @brief parse the shader file that contains both vertex and fragment 
+ * shader
+ * 
+ * @param filePath of the shader file 
+ * @return ShaderProgramSource containing vertex and fragments code strings
+ */
+ShaderProgramSource parseShader(const std::string& filePath);
+
+/**
+ * @brief function to compile the source code for a shader
+ * @param type of shader to create
+ * @param source of the shader
+ * @return unsigned int the id of the shader
+ */
+GLuint CompileShader(GLuint type, const std::string& source);
+
+/**
+ * @brief Create a Shader, attach it to a Program and return the program id.
+ * @param vertexShader the vertex shader source
+ * @param fragmentShader the fragment shader source
+ * @return unsigned int the id of the program
+ */
+GLuint CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
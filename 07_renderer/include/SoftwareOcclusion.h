@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Bvh.h"
+#include "VectorMath.h"
+
+
+/**
+ * @brief CPU occlusion culling: the occluders are rasterized into a small 
+ * depth buffer, a Hi-Z pyramid (farthest depth of each 2x2 block, level 
+ * after level) is built from it and object bounds are tested against the 
+ * pyramid before their draws are recorded. No GPU, no readback.
+ * 
+ * The screen is split in tiles, triangles are binned per tile then the 
+ * tiles are rasterized in parallel, 4 pixels at a time with SSE (scalar 
+ * on other CPUs). Pixels are covered only when their center is strictly 
+ * inside a triangle, occluders never grow: an object is culled only if it 
+ * is really hidden, up to the resolution of the buffer.
+ * 
+ * Depth is NDC z remapped to [0, 1], 0 near. Triangles with a vertex in 
+ * front of the near plane (z < -w, clipped by GL) are skipped, they would
+ * only hide more, back faces too.
+ */
+class SoftwareOcclusion {
+public:
+    static const uint32_t TileWidth = 32;
+    static const uint32_t TileHeight = 16;
+
+    /**
+     * @param width multiple of TileWidth
+     * @param height multiple of TileHeight
+     */
+    SoftwareOcclusion(uint32_t width = 256, uint32_t height = 128);
+
+    /**
+     * @brief clear the depth and the occluders
+     * @param viewProjection column major (GL) matrix
+     */
+    void Begin(const float viewProjection[16]);
+
+    /**
+     * @brief bin the triangles of an occluder, counter clockwise front faces
+     * @param positions first 3 floats of each vertex, vertexStride bytes apart
+     * @param model column major object to world matrix, null for identity
+     */
+    void AddOccluder(const float* positions, size_t vertexStride, const uint32_t* indices, size_t indexCount, 
+        const float* model = nullptr);
+
+    /**
+     * @brief rasterize the tiles and build the pyramid
+     * @param maxThreads 0 for one per core
+     */
+    void Rasterize(unsigned int maxThreads = 0);
+
+    /**
+     * @return false when the box is outside the view or behind the occluders
+     */
+    bool IsVisible(const Aabb& bounds) const;
+
+    uint32_t GetWidth() const { return m_Width; }
+    uint32_t GetHeight() const { return m_Height; }
+    size_t GetTriangleCount() const { return m_Triangles.size(); }
+    const std::vector<float>& GetDepth() const { return m_Levels[0]; }
+
+private:
+    struct Triangle {
+        float X[3], Y[3], Z[3];     // pixels, depth
+    };
+
+    void RasterizeTile(uint32_t tile);
+
+    uint32_t m_Width, m_Height;
+    uint32_t m_TilesX, m_TilesY;
+    Mat4 m_ViewProjection;
+    std::vector<Triangle> m_Triangles;
+    std::vector<std::vector<uint32_t>> m_Bins;
+    // level 0 is the depth buffer, then half the size each level
+    std::vector<std::vector<float>> m_Levels;
+    std::vector<uint32_t> m_LevelWidth, m_LevelHeight;
+};
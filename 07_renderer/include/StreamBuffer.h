@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+#include "Debug.h"
+
+
+/**
+ * @brief ring buffer used to stream dynamic data (vertices, indices, 
+ * instances) to the GPU every frame without calling glBufferData.
+ * 
+ * The storage is allocated once with glBufferStorage and mapped persistently 
+ * and coherently, so Allocate() hands out a pointer straight into GPU visible 
+ * memory: we write there, then draw at Allocation::Offset. Every frame is 
+ * closed by EndFrame(), which drops a glFenceSync: a region is reused only 
+ * once the GPU has signaled the fence of the frame that wrote it.
+ * 
+ * When GL_ARB_buffer_storage is missing (e.g. the 4.1 core context on macOS) 
+ * we fall back to glMapBufferRange with GL_MAP_UNSYNCHRONIZED_BIT on each 
+ * allocation, the fences still protect the data in flight.
+ */
+class StreamBuffer {
+public:
+    struct Allocation {
+        void* Data;         // where to write, valid until Commit()
+        GLintptr Offset;    // byte offset inside the GL buffer
+        GLsizeiptr Size;    // size in bytes
+    };
+
+    /**
+     * @brief create the ring buffer
+     * @param bytesPerFrame the most data a single frame will ever stream
+     * @param framesInFlight how many frames the GPU may lag behind
+     */
+    StreamBuffer(GLsizeiptr bytesPerFrame, unsigned int framesInFlight = 3);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /**
+     * @brief reserve size bytes in the ring, waiting on older frames only if 
+     * the GPU is still reading the region. If a single frame streams more 
+     * than the whole ring, the frame is fenced early and waited on: the 
+     * previous allocations must have been drawn already.
+     * @param size in bytes
+     * @param alignment of the returned offset (does not need to be a power 
+     * of two, e.g. pass the vertex stride to draw with a base vertex)
+     * @return Allocation to be filled, then committed
+     */
+    Allocation Allocate(GLsizeiptr size, GLsizeiptr alignment = 4);
+
+    /**
+     * @brief make the written data visible to the GPU, call it before the 
+     * draw that sources the allocation (no-op on the persistent path)
+     */
+    void Commit(const Allocation& allocation);
+
+    /**
+     * @brief fence everything allocated since the previous EndFrame(), to be 
+     * called after the last draw that reads from this buffer in the frame
+     */
+    void EndFrame();
+
+    GLuint GetID() const { return m_RendererID; }
+    GLsizeiptr GetCapacity() const { return m_Capacity; }
+    bool IsPersistent() const { return m_Mapped != nullptr; }
+
+private:
+    struct FrameFence {
+        GLsync Fence;
+        uint64_t End;       // m_Head when the frame was closed
+    };
+
+    void WaitForOldestFrame();
+
+    GLuint m_RendererID;
+    GLsizeiptr m_Capacity;
+    char* m_Mapped;         // persistent pointer, nullptr on the fallback path
+
+    // monotonic byte counters, the ring position is counter % m_Capacity
+    uint64_t m_Head;        // next byte to write
+    uint64_t m_Tail;        // oldest byte the GPU may still read
+    uint64_t m_FrameStart;
+    std::deque<FrameFence> m_Frames;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "InstanceRenderer.h"
+#include "VectorMath.h"
+
+
+/**
+ * @brief parent / child transforms, world = parent world * local.
+ *
+ * The nodes are kept sorted by depth in flat arrays (local matrices, world
+ * matrices, parent positions), so the parents of a level are all computed
+ * before it: Update() goes level by level, the nodes of a level in parallel,
+ * a 4x4 multiply each (Multiply() of VectorMath.h). The world matrices then go
+ * straight into the instance buffer with WriteInstances().
+ *
+ * Matrices are column major (GL), 16 floats.
+ */
+class TransformHierarchy {
+public:
+    typedef uint32_t Node;
+    static const Node None = 0xFFFFFFFF;
+
+    TransformHierarchy() : m_Dirty(false) {}
+
+    /**
+     * @param parent None for a root, must already be there
+     */
+    Node Add(const float local[16], Node parent = None);
+    void SetLocal(Node node, const float local[16]);
+    void Clear();
+
+    /**
+     * @brief recompute every world matrix, sorts the nodes first when some
+     * were added
+     * @param maxThreads 0 for one per core
+     */
+    void Update(unsigned int maxThreads = 0);
+
+    /**
+     * @brief as of the last Update()
+     */
+    const float* GetWorld(Node node) const { return m_World[m_Position[node]].Values; }
+
+    /**
+     * @brief the 3 first rows of the world matrices (InstanceData::Transform),
+     * colors are left alone
+     */
+    void WriteInstances(const Node* nodes, size_t count, InstanceData* instances) const;
+
+    size_t GetNodeCount() const { return m_Position.size(); }
+    size_t GetLevelCount() const { return m_LevelStart.empty() ? 0 : m_LevelStart.size() - 1; }
+
+private:
+    void Sort();
+
+    // by position: sorted by depth (roots first) after Sort(), nodes added 
+    // since are at the end
+    std::vector<Mat4> m_Local;
+    std::vector<Mat4> m_World;
+    std::vector<uint32_t> m_Parent;     // position of the parent, None for roots
+    std::vector<Node> m_Node;
+    std::vector<uint32_t> m_LevelStart; // first position of each depth, + end
+    // by node
+    std::vector<uint32_t> m_Position;
+    std::vector<uint32_t> m_Depth;
+    bool m_Dirty;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+
+/**
+ * @brief hands values from one producer thread to one consumer thread,
+ * neither ever waits for the other.
+ *
+ * Three slots: the producer fills one, the consumer reads another, the
+ * third is the last published one. Publish() and Acquire() swap their slot
+ * with the middle one in a single atomic exchange. The consumer always gets
+ * the newest value, the ones it didn't take in time are overwritten.
+ *
+ * The slots are reused: the producer fills a slot that may still hold an
+ * old value (containers keep their capacity, nothing is allocated once they
+ * have grown).
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : m_Middle(1), m_Write(0), m_Read(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief producer side, the slot to fill
+     */
+    T& GetWrite() { return m_Slots[m_Write]; }
+
+    /**
+     * @brief producer side, makes the written slot the newest one
+     * @return true when the previous one was overwritten before the consumer
+     * took it
+     */
+    bool Publish() {
+        uint8_t previous = m_Middle.exchange(m_Write | FRESH, std::memory_order_acq_rel);
+        m_Write = previous & INDEX;
+        return (previous & FRESH) != 0;
+    }
+
+    /**
+     * @brief consumer side, switches to the newest slot
+     * @return false when nothing was published since the last call, the
+     * read slot stays the same
+     */
+    bool Acquire() {
+        if (!(m_Middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        uint8_t previous = m_Middle.exchange(m_Read, std::memory_order_acq_rel);
+        m_Read = previous & INDEX;
+        return true;
+    }
+
+    /**
+     * @brief consumer side, the slot taken by the last Acquire()
+     */
+    T& GetRead() { return m_Slots[m_Read]; }
+
+private:
+    static const uint8_t INDEX = 3;
+    static const uint8_t FRESH = 4;     // published, not acquired yet
+
+    T m_Slots[3];
+    std::atomic<uint8_t> m_Middle;      // index of the middle slot | FRESH
+    // each only touched by its own side
+    alignas(64) uint8_t m_Write;
+    alignas(64) uint8_t m_Read;
+};
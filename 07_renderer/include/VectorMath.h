@@ -0,0 +1,544 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATH_SSE
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#define MATH_NEON
+#include <arm_neon.h>
+#endif
+
+
+/**
+ * @brief small vector math, header only.
+ *
+ * Everything works in constexpr scalar code, the hot paths (4x4 multiply,
+ * batches of points and matrices) have SSE and NEON versions, plus AVX
+ * picked at runtime for the batches. Matrices are column major like GL:
+ * Values[column * 4 + row], a vector is transformed as M * v.
+ */
+
+struct Vec2 {
+    float X, Y;
+};
+
+struct Vec3 {
+    float X, Y, Z;
+};
+
+struct alignas(16) Vec4 {
+    float X, Y, Z, W;
+};
+
+constexpr Vec2 operator+(Vec2 a, Vec2 b) { return { a.X + b.X, a.Y + b.Y }; }
+constexpr Vec2 operator-(Vec2 a, Vec2 b) { return { a.X - b.X, a.Y - b.Y }; }
+constexpr Vec2 operator*(Vec2 a, float s) { return { a.X * s, a.Y * s }; }
+constexpr Vec2 operator*(Vec2 a, Vec2 b) { return { a.X * b.X, a.Y * b.Y }; }
+constexpr float Dot(Vec2 a, Vec2 b) { return a.X * b.X + a.Y * b.Y; }
+
+constexpr Vec3 operator+(Vec3 a, Vec3 b) { return { a.X + b.X, a.Y + b.Y, a.Z + b.Z }; }
+constexpr Vec3 operator-(Vec3 a, Vec3 b) { return { a.X - b.X, a.Y - b.Y, a.Z - b.Z }; }
+constexpr Vec3 operator-(Vec3 a) { return { -a.X, -a.Y, -a.Z }; }
+constexpr Vec3 operator*(Vec3 a, float s) { return { a.X * s, a.Y * s, a.Z * s }; }
+constexpr Vec3 operator*(Vec3 a, Vec3 b) { return { a.X * b.X, a.Y * b.Y, a.Z * b.Z }; }
+constexpr float Dot(Vec3 a, Vec3 b) { return a.X * b.X + a.Y * b.Y + a.Z * b.Z; }
+constexpr Vec3 Cross(Vec3 a, Vec3 b) { return { a.Y * b.Z - a.Z * b.Y, a.Z * b.X - a.X * b.Z, a.X * b.Y - a.Y * b.X }; }
+constexpr Vec3 Min(Vec3 a, Vec3 b) { return { std::min(a.X, b.X), std::min(a.Y, b.Y), std::min(a.Z, b.Z) }; }
+constexpr Vec3 Max(Vec3 a, Vec3 b) { return { std::max(a.X, b.X), std::max(a.Y, b.Y), std::max(a.Z, b.Z) }; }
+constexpr Vec3 Lerp(Vec3 a, Vec3 b, float t) { return a + (b - a) * t; }
+
+constexpr Vec4 operator+(Vec4 a, Vec4 b) { return { a.X + b.X, a.Y + b.Y, a.Z + b.Z, a.W + b.W }; }
+constexpr Vec4 operator-(Vec4 a, Vec4 b) { return { a.X - b.X, a.Y - b.Y, a.Z - b.Z, a.W - b.W }; }
+constexpr Vec4 operator*(Vec4 a, float s) { return { a.X * s, a.Y * s, a.Z * s, a.W * s }; }
+constexpr float Dot(Vec4 a, Vec4 b) { return a.X * b.X + a.Y * b.Y + a.Z * b.Z + a.W * b.W; }
+
+inline float Length(Vec2 v) { return std::sqrt(Dot(v, v)); }
+inline float Length(Vec3 v) { return std::sqrt(Dot(v, v)); }
+inline float Length(Vec4 v) { return std::sqrt(Dot(v, v)); }
+
+/**
+ * @brief v unchanged when its length is 0
+ */
+inline Vec3 Normalize(Vec3 v) {
+    float length = Length(v);
+    return length > 0.0f ? v * (1.0f / length) : v;
+}
+
+
+/**
+ * @brief column major 3x3, rotation and scale
+ */
+struct Mat3 {
+    float Values[9];
+
+    static constexpr Mat3 Identity() { return { { 1, 0, 0,  0, 1, 0,  0, 0, 1 } }; }
+};
+
+constexpr Mat3 operator*(const Mat3& a, const Mat3& b) {
+    Mat3 out = {};
+    for (int c = 0; c < 3; c++) {
+        for (int r = 0; r < 3; r++)
+            out.Values[c * 3 + r] = a.Values[r] * b.Values[c * 3] + a.Values[3 + r] * b.Values[c * 3 + 1] +
+                a.Values[6 + r] * b.Values[c * 3 + 2];
+    }
+    return out;
+}
+
+constexpr Vec3 operator*(const Mat3& m, Vec3 v) {
+    return { m.Values[0] * v.X + m.Values[3] * v.Y + m.Values[6] * v.Z,
+        m.Values[1] * v.X + m.Values[4] * v.Y + m.Values[7] * v.Z,
+        m.Values[2] * v.X + m.Values[5] * v.Y + m.Values[8] * v.Z };
+}
+
+constexpr Mat3 Transpose(const Mat3& m) {
+    return { { m.Values[0], m.Values[3], m.Values[6],  m.Values[1], m.Values[4], m.Values[7],
+        m.Values[2], m.Values[5], m.Values[8] } };
+}
+
+
+/**
+ * @brief column major 4x4, the layout glUniformMatrix4fv expects
+ */
+struct alignas(16) Mat4 {
+    float Values[16];
+
+    static constexpr Mat4 Identity() { return { { 1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1 } }; }
+    static constexpr Mat4 Translation(Vec3 t) { return { { 1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  t.X, t.Y, t.Z, 1 } }; }
+    static constexpr Mat4 Scale(Vec3 s) { return { { s.X, 0, 0, 0,  0, s.Y, 0, 0,  0, 0, s.Z, 0,  0, 0, 0, 1 } }; }
+
+    /**
+     * @brief GL perspective projection, depth to [-1, 1]
+     * @param fovY radians
+     */
+    static Mat4 Perspective(float fovY, float aspect, float zNear, float zFar) {
+        float f = 1.0f / std::tan(fovY * 0.5f), range = zNear - zFar;
+        return { { f / aspect, 0, 0, 0,  0, f, 0, 0,  0, 0, (zFar + zNear) / range, -1,
+            0, 0, 2.0f * zFar * zNear / range, 0 } };
+    }
+
+    static Mat4 LookAt(Vec3 eye, Vec3 target, Vec3 up) {
+        Vec3 f = Normalize(target - eye), s = Normalize(Cross(f, up)), u = Cross(s, f);
+        return { { s.X, u.X, -f.X, 0,  s.Y, u.Y, -f.Y, 0,  s.Z, u.Z, -f.Z, 0,
+            -Dot(s, eye), -Dot(u, eye), Dot(f, eye), 1 } };
+    }
+};
+
+constexpr Mat4 MultiplyScalar(const Mat4& a, const Mat4& b) {
+    Mat4 out = {};
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++)
+            out.Values[c * 4 + r] = a.Values[r] * b.Values[c * 4] + a.Values[4 + r] * b.Values[c * 4 + 1] +
+                a.Values[8 + r] * b.Values[c * 4 + 2] + a.Values[12 + r] * b.Values[c * 4 + 3];
+    }
+    return out;
+}
+
+/**
+ * @brief out = a * b, out may be a or b. Column c of out is the columns of a
+ * weighted by column c of b.
+ */
+inline void Multiply(Mat4& out, const Mat4& a, const Mat4& b) {
+#if defined(MATH_SSE)
+    __m128 a0 = _mm_load_ps(a.Values), a1 = _mm_load_ps(a.Values + 4);
+    __m128 a2 = _mm_load_ps(a.Values + 8), a3 = _mm_load_ps(a.Values + 12);
+    __m128 columns[4];
+    for (int c = 0; c < 4; c++) {
+        const float* w = b.Values + c * 4;
+        columns[c] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, _mm_set1_ps(w[0])), _mm_mul_ps(a1, _mm_set1_ps(w[1]))),
+            _mm_add_ps(_mm_mul_ps(a2, _mm_set1_ps(w[2])), _mm_mul_ps(a3, _mm_set1_ps(w[3]))));
+    }
+    for (int c = 0; c < 4; c++)
+        _mm_store_ps(out.Values + c * 4, columns[c]);
+#elif defined(MATH_NEON)
+    float32x4_t a0 = vld1q_f32(a.Values), a1 = vld1q_f32(a.Values + 4);
+    float32x4_t a2 = vld1q_f32(a.Values + 8), a3 = vld1q_f32(a.Values + 12);
+    float32x4_t columns[4];
+    for (int c = 0; c < 4; c++) {
+        const float* w = b.Values + c * 4;
+        columns[c] = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(a0, w[0]), a1, w[1]), a2, w[2]), a3, w[3]);
+    }
+    for (int c = 0; c < 4; c++)
+        vst1q_f32(out.Values + c * 4, columns[c]);
+#else
+    out = MultiplyScalar(a, b);
+#endif
+}
+
+inline Mat4 operator*(const Mat4& a, const Mat4& b) {
+    Mat4 out;
+    Multiply(out, a, b);
+    return out;
+}
+
+constexpr Vec4 operator*(const Mat4& m, Vec4 v) {
+    return { m.Values[0] * v.X + m.Values[4] * v.Y + m.Values[8] * v.Z + m.Values[12] * v.W,
+        m.Values[1] * v.X + m.Values[5] * v.Y + m.Values[9] * v.Z + m.Values[13] * v.W,
+        m.Values[2] * v.X + m.Values[6] * v.Y + m.Values[10] * v.Z + m.Values[14] * v.W,
+        m.Values[3] * v.X + m.Values[7] * v.Y + m.Values[11] * v.Z + m.Values[15] * v.W };
+}
+
+/**
+ * @brief M * (p, 1) without the projective divide
+ */
+constexpr Vec3 TransformPoint(const Mat4& m, Vec3 p) {
+    return { m.Values[0] * p.X + m.Values[4] * p.Y + m.Values[8] * p.Z + m.Values[12],
+        m.Values[1] * p.X + m.Values[5] * p.Y + m.Values[9] * p.Z + m.Values[13],
+        m.Values[2] * p.X + m.Values[6] * p.Y + m.Values[10] * p.Z + m.Values[14] };
+}
+
+/**
+ * @brief M * (d, 0)
+ */
+constexpr Vec3 TransformDirection(const Mat4& m, Vec3 d) {
+    return { m.Values[0] * d.X + m.Values[4] * d.Y + m.Values[8] * d.Z,
+        m.Values[1] * d.X + m.Values[5] * d.Y + m.Values[9] * d.Z,
+        m.Values[2] * d.X + m.Values[6] * d.Y + m.Values[10] * d.Z };
+}
+
+constexpr Mat4 Transpose(const Mat4& m) {
+    Mat4 out = {};
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++)
+            out.Values[r * 4 + c] = m.Values[c * 4 + r];
+    }
+    return out;
+}
+
+/**
+ * @brief general inverse (cofactors)
+ * @return false when m is singular, out is then left alone
+ */
+inline bool Invert(const Mat4& m, Mat4& out) {
+    const float* a = m.Values;
+    float s0 = a[0] * a[5] - a[1] * a[4], s1 = a[0] * a[6] - a[2] * a[4], s2 = a[0] * a[7] - a[3] * a[4];
+    float s3 = a[1] * a[6] - a[2] * a[5], s4 = a[1] * a[7] - a[3] * a[5], s5 = a[2] * a[7] - a[3] * a[6];
+    float c5 = a[10] * a[15] - a[11] * a[14], c4 = a[9] * a[15] - a[11] * a[13], c3 = a[9] * a[14] - a[10] * a[13];
+    float c2 = a[8] * a[15] - a[11] * a[12], c1 = a[8] * a[14] - a[10] * a[12], c0 = a[8] * a[13] - a[9] * a[12];
+    float determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    if (determinant == 0.0f)
+        return false;
+
+    float d = 1.0f / determinant;
+    out.Values[0] = (a[5] * c5 - a[6] * c4 + a[7] * c3) * d;
+    out.Values[1] = (-a[1] * c5 + a[2] * c4 - a[3] * c3) * d;
+    out.Values[2] = (a[13] * s5 - a[14] * s4 + a[15] * s3) * d;
+    out.Values[3] = (-a[9] * s5 + a[10] * s4 - a[11] * s3) * d;
+    out.Values[4] = (-a[4] * c5 + a[6] * c2 - a[7] * c1) * d;
+    out.Values[5] = (a[0] * c5 - a[2] * c2 + a[3] * c1) * d;
+    out.Values[6] = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * d;
+    out.Values[7] = (a[8] * s5 - a[10] * s2 + a[11] * s1) * d;
+    out.Values[8] = (a[4] * c4 - a[5] * c2 + a[7] * c0) * d;
+    out.Values[9] = (-a[0] * c4 + a[1] * c2 - a[3] * c0) * d;
+    out.Values[10] = (a[12] * s4 - a[13] * s2 + a[15] * s0) * d;
+    out.Values[11] = (-a[8] * s4 + a[9] * s2 - a[11] * s0) * d;
+    out.Values[12] = (-a[4] * c3 + a[5] * c1 - a[6] * c0) * d;
+    out.Values[13] = (a[0] * c3 - a[1] * c1 + a[2] * c0) * d;
+    out.Values[14] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * d;
+    out.Values[15] = (a[8] * s3 - a[9] * s1 + a[10] * s0) * d;
+    return true;
+}
+
+
+/**
+ * @brief rotation quaternion, W is the real part
+ */
+struct Quat {
+    float X, Y, Z, W;
+
+    static constexpr Quat Identity() { return { 0, 0, 0, 1 }; }
+
+    /**
+     * @param axis unit length
+     * @param angle radians
+     */
+    static Quat FromAxisAngle(Vec3 axis, float angle) {
+        float s = std::sin(angle * 0.5f);
+        return { axis.X * s, axis.Y * s, axis.Z * s, std::cos(angle * 0.5f) };
+    }
+};
+
+/**
+ * @brief a * b rotates by b then by a
+ */
+constexpr Quat operator*(Quat a, Quat b) {
+    return { a.W * b.X + a.X * b.W + a.Y * b.Z - a.Z * b.Y,
+        a.W * b.Y - a.X * b.Z + a.Y * b.W + a.Z * b.X,
+        a.W * b.Z + a.X * b.Y - a.Y * b.X + a.Z * b.W,
+        a.W * b.W - a.X * b.X - a.Y * b.Y - a.Z * b.Z };
+}
+
+constexpr Quat Conjugate(Quat q) { return { -q.X, -q.Y, -q.Z, q.W }; }
+constexpr float Dot(Quat a, Quat b) { return a.X * b.X + a.Y * b.Y + a.Z * b.Z + a.W * b.W; }
+
+inline Quat Normalize(Quat q) {
+    float length = std::sqrt(Dot(q, q));
+    float s = length > 0.0f ? 1.0f / length : 0.0f;
+    return { q.X * s, q.Y * s, q.Z * s, q.W * s };
+}
+
+/**
+ * @brief q v q*, for a unit q
+ */
+constexpr Vec3 Rotate(Quat q, Vec3 v) {
+    Vec3 u = { q.X, q.Y, q.Z };
+    Vec3 t = Cross(u, v) * 2.0f;
+    return v + t * q.W + Cross(u, t);
+}
+
+/**
+ * @brief normalized lerp along the shortest arc: cheap, close to Slerp() for
+ * small angles
+ */
+inline Quat Nlerp(Quat a, Quat b, float t) {
+    float sign = Dot(a, b) < 0.0f ? -1.0f : 1.0f;
+    return Normalize({ a.X + (b.X * sign - a.X) * t, a.Y + (b.Y * sign - a.Y) * t,
+        a.Z + (b.Z * sign - a.Z) * t, a.W + (b.W * sign - a.W) * t });
+}
+
+inline Quat Slerp(Quat a, Quat b, float t) {
+    float cosine = Dot(a, b);
+    if (cosine < 0.0f) {
+        b = { -b.X, -b.Y, -b.Z, -b.W };
+        cosine = -cosine;
+    }
+    if (cosine > 0.9995f)
+        return Nlerp(a, b, t);
+    float angle = std::acos(cosine), s = 1.0f / std::sin(angle);
+    float wa = std::sin((1.0f - t) * angle) * s, wb = std::sin(t * angle) * s;
+    return { a.X * wa + b.X * wb, a.Y * wa + b.Y * wb, a.Z * wa + b.Z * wb, a.W * wa + b.W * wb };
+}
+
+constexpr Mat3 ToMat3(Quat q) {
+    float xx = q.X * q.X, yy = q.Y * q.Y, zz = q.Z * q.Z;
+    float xy = q.X * q.Y, xz = q.X * q.Z, yz = q.Y * q.Z, wx = q.W * q.X, wy = q.W * q.Y, wz = q.W * q.Z;
+    return { { 1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy),
+        2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx),
+        2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy) } };
+}
+
+/**
+ * @brief translation * rotation * scale
+ */
+constexpr Mat4 Compose(Vec3 translation, Quat rotation, Vec3 scale) {
+    Mat3 r = ToMat3(rotation);
+    return { { r.Values[0] * scale.X, r.Values[1] * scale.X, r.Values[2] * scale.X, 0,
+        r.Values[3] * scale.Y, r.Values[4] * scale.Y, r.Values[5] * scale.Y, 0,
+        r.Values[6] * scale.Z, r.Values[7] * scale.Z, r.Values[8] * scale.Z, 0,
+        translation.X, translation.Y, translation.Z, 1 } };
+}
+
+
+/**
+ * @brief n . p + d >= 0 on the inner side
+ */
+struct Plane {
+    float Normal[3];
+    float Distance;
+
+    /**
+     * @param normal unit length
+     */
+    static constexpr Plane FromPointNormal(Vec3 point, Vec3 normal) {
+        return { { normal.X, normal.Y, normal.Z }, -Dot(normal, point) };
+    }
+
+    constexpr float Evaluate(const float p[3]) const {
+        return Normal[0] * p[0] + Normal[1] * p[1] + Normal[2] * p[2] + Distance;
+    }
+    constexpr float Evaluate(Vec3 p) const { return Normal[0] * p.X + Normal[1] * p.Y + Normal[2] * p.Z + Distance; }
+};
+
+struct Aabb {
+    float Min[3];
+    float Max[3];
+
+    static constexpr Aabb Union(const Aabb& a, const Aabb& b) {
+        Aabb result = {};
+        for (int axis = 0; axis < 3; axis++) {
+            result.Min[axis] = std::min(a.Min[axis], b.Min[axis]);
+            result.Max[axis] = std::max(a.Max[axis], b.Max[axis]);
+        }
+        return result;
+    }
+
+    constexpr float SurfaceArea() const {
+        float x = Max[0] - Min[0], y = Max[1] - Min[1], z = Max[2] - Min[2];
+        return 2.0f * (x * y + y * z + z * x);
+    }
+
+    constexpr bool Contains(const Aabb& other) const {
+        for (int axis = 0; axis < 3; axis++) {
+            if (other.Min[axis] < Min[axis] || other.Max[axis] > Max[axis])
+                return false;
+        }
+        return true;
+    }
+
+    constexpr Vec3 GetCenter() const {
+        return { (Min[0] + Max[0]) * 0.5f, (Min[1] + Max[1]) * 0.5f, (Min[2] + Max[2]) * 0.5f };
+    }
+    constexpr Vec3 GetExtents() const {
+        return { (Max[0] - Min[0]) * 0.5f, (Max[1] - Min[1]) * 0.5f, (Max[2] - Min[2]) * 0.5f };
+    }
+
+    /**
+     * @brief box around the transformed box: the center moves, the extents
+     * go through the absolute matrix (Arvo)
+     */
+    Aabb Transform(const Mat4& m) const {
+        Vec3 center = TransformPoint(m, GetCenter()), extents = GetExtents();
+        Aabb result = {};
+        for (int r = 0; r < 3; r++) {
+            float e = std::fabs(m.Values[r]) * extents.X + std::fabs(m.Values[4 + r]) * extents.Y +
+                std::fabs(m.Values[8 + r]) * extents.Z;
+            float c = r == 0 ? center.X : r == 1 ? center.Y : center.Z;
+            result.Min[r] = c - e;
+            result.Max[r] = c + e;
+        }
+        return result;
+    }
+};
+
+
+#ifdef MATH_SSE
+inline bool MathHasAvx() {
+    static const bool avx = __builtin_cpu_supports("avx");
+    return avx;
+}
+
+__attribute__((target("avx")))
+inline void MultiplyMatricesAVX(const Mat4* a, const Mat4* b, Mat4* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        // the columns of a in both halves, 2 columns of out per step
+        __m256 a0 = _mm256_broadcast_ps((const __m128*)a[i].Values);
+        __m256 a1 = _mm256_broadcast_ps((const __m128*)(a[i].Values + 4));
+        __m256 a2 = _mm256_broadcast_ps((const __m128*)(a[i].Values + 8));
+        __m256 a3 = _mm256_broadcast_ps((const __m128*)(a[i].Values + 12));
+        __m256 columns[2];
+        for (int c = 0; c < 4; c += 2) {
+            const float* w = b[i].Values + c * 4;
+            __m256 w0 = _mm256_setr_ps(w[0], w[0], w[0], w[0], w[4], w[4], w[4], w[4]);
+            __m256 w1 = _mm256_setr_ps(w[1], w[1], w[1], w[1], w[5], w[5], w[5], w[5]);
+            __m256 w2 = _mm256_setr_ps(w[2], w[2], w[2], w[2], w[6], w[6], w[6], w[6]);
+            __m256 w3 = _mm256_setr_ps(w[3], w[3], w[3], w[3], w[7], w[7], w[7], w[7]);
+            columns[c / 2] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a0, w0), _mm256_mul_ps(a1, w1)),
+                _mm256_add_ps(_mm256_mul_ps(a2, w2), _mm256_mul_ps(a3, w3)));
+        }
+        _mm256_storeu_ps(out[i].Values, columns[0]);
+        _mm256_storeu_ps(out[i].Values + 8, columns[1]);
+    }
+}
+
+__attribute__((target("avx")))
+inline size_t TransformPointsAVX(const Mat4& m, const float* x, const float* y, const float* z,
+    float* outX, float* outY, float* outZ, size_t count) {
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i), pz = _mm256_loadu_ps(z + i);
+        __m256 r[3];
+        for (int row = 0; row < 3; row++) {
+            r[row] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m.Values[row]), px),
+                _mm256_mul_ps(_mm256_set1_ps(m.Values[4 + row]), py)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m.Values[8 + row]), pz), _mm256_set1_ps(m.Values[12 + row])));
+        }
+        _mm256_storeu_ps(outX + i, r[0]);
+        _mm256_storeu_ps(outY + i, r[1]);
+        _mm256_storeu_ps(outZ + i, r[2]);
+    }
+    return i;
+}
+#endif
+
+/**
+ * @brief out[i] = a[i] * b[i], out may alias a or b
+ */
+inline void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count) {
+#ifdef MATH_SSE
+    if (MathHasAvx()) {
+        MultiplyMatricesAVX(a, b, out, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++)
+        Multiply(out[i], a[i], b[i]);
+}
+
+/**
+ * @brief out[i] = M * (points[i], 1), out may be points
+ */
+inline void TransformPoints(const Mat4& m, const Vec3* points, Vec3* out, size_t count) {
+#if defined(MATH_SSE)
+    __m128 c0 = _mm_load_ps(m.Values), c1 = _mm_load_ps(m.Values + 4);
+    __m128 c2 = _mm_load_ps(m.Values + 8), c3 = _mm_load_ps(m.Values + 12);
+    for (size_t i = 0; i < count; i++) {
+        Vec3 p = points[i];
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(p.X)), _mm_mul_ps(c1, _mm_set1_ps(p.Y))),
+            _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(p.Z)), c3));
+        _mm_storel_pi((__m64*)&out[i].X, r);
+        _mm_store_ss(&out[i].Z, _mm_movehl_ps(r, r));
+    }
+#elif defined(MATH_NEON)
+    float32x4_t c0 = vld1q_f32(m.Values), c1 = vld1q_f32(m.Values + 4);
+    float32x4_t c2 = vld1q_f32(m.Values + 8), c3 = vld1q_f32(m.Values + 12);
+    for (size_t i = 0; i < count; i++) {
+        Vec3 p = points[i];
+        float32x4_t r = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(c3, c0, p.X), c1, p.Y), c2, p.Z);
+        vst1_f32(&out[i].X, vget_low_f32(r));
+        out[i].Z = vgetq_lane_f32(r, 2);
+    }
+#else
+    for (size_t i = 0; i < count; i++)
+        out[i] = TransformPoint(m, points[i]);
+#endif
+}
+
+/**
+ * @brief TransformPoints() on SoA coordinates, 8 points per step with AVX,
+ * 4 with SSE / NEON
+ */
+inline void TransformPoints(const Mat4& m, const float* x, const float* y, const float* z,
+    float* outX, float* outY, float* outZ, size_t count) {
+
+    size_t i = 0;
+#if defined(MATH_SSE)
+    if (MathHasAvx()) {
+        i = TransformPointsAVX(m, x, y, z, outX, outY, outZ, count);
+    } else {
+        for (; i + 4 <= count; i += 4) {
+            __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i), pz = _mm_loadu_ps(z + i);
+            __m128 r[3];
+            for (int row = 0; row < 3; row++) {
+                r[row] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m.Values[row]), px),
+                    _mm_mul_ps(_mm_set1_ps(m.Values[4 + row]), py)),
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m.Values[8 + row]), pz), _mm_set1_ps(m.Values[12 + row])));
+            }
+            _mm_storeu_ps(outX + i, r[0]);
+            _mm_storeu_ps(outY + i, r[1]);
+            _mm_storeu_ps(outZ + i, r[2]);
+        }
+    }
+#elif defined(MATH_NEON)
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t px = vld1q_f32(x + i), py = vld1q_f32(y + i), pz = vld1q_f32(z + i);
+        float32x4_t r[3];
+        for (int row = 0; row < 3; row++) {
+            r[row] = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m.Values[12 + row]), px, m.Values[row]),
+                py, m.Values[4 + row]), pz, m.Values[8 + row]);
+        }
+        vst1q_f32(outX + i, r[0]);
+        vst1q_f32(outY + i, r[1]);
+        vst1q_f32(outZ + i, r[2]);
+    }
+#endif
+    for (; i < count; i++) {
+        Vec3 p = TransformPoint(m, { x[i], y[i], z[i] });
+        outX[i] = p.X;
+        outY[i] = p.Y;
+        outZ[i] = p.Z;
+    }
+}
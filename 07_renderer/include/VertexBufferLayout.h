@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+
+#include "Debug.h"
+
+
+struct VertexBufferElement {
+    GLenum Type;
+    GLint Count;
+    GLboolean Normalized;
+
+    static GLsizei GetSizeOfType(GLenum type) {
+        switch (type) {
+            case GL_FLOAT:          return 4;
+            case GL_UNSIGNED_INT:   return 4;
+            case GL_INT:            return 4;
+            case GL_HALF_FLOAT:     return 2;
+            case GL_SHORT:          return 2;
+            case GL_UNSIGNED_SHORT: return 2;
+            case GL_BYTE:           return 1;
+            case GL_UNSIGNED_BYTE:  return 1;
+        }
+        ASSERT(false);
+        return 0;
+    }
+
+    /**
+     * @brief bytes taken by the element inside a vertex, packed formats 
+     * hold all their components in a single 32 bit word
+     */
+    GLsizei GetSize() const {
+        if (Type == GL_INT_2_10_10_10_REV || Type == GL_UNSIGNED_INT_2_10_10_10_REV)
+            return 4;
+        return Count * GetSizeOfType(Type);
+    }
+};
+
+/**
+ * @brief describes how the vertices of a buffer are laid out, what we 
+ * used to write by hand with glVertexAttribPointer. Every Push() adds the 
+ * next attribute location, interleaved after the previous ones.
+ */
+class VertexBufferLayout {
+public:
+    VertexBufferLayout() : m_Stride(0) {}
+
+    void Push(GLenum type, GLint count, GLboolean normalized = GL_FALSE) {
+        m_Elements.push_back({type, count, normalized});
+        m_Stride += m_Elements.back().GetSize();
+    }
+
+    /**
+     * @brief set the attribute pointers of the bound VAO to the bound 
+     * GL_ARRAY_BUFFER
+     * @param offset in bytes of the first vertex inside the buffer
+     */
+    void Apply(GLintptr offset = 0) const {
+        for (unsigned int i = 0; i < m_Elements.size(); i++) {
+            const VertexBufferElement& element = m_Elements[i];
+            GLCall( glEnableVertexAttribArray(i) );
+            GLCall( glVertexAttribPointer(i, element.Count, element.Type, element.Normalized, 
+                m_Stride, (const GLvoid*)offset) );
+            offset += element.GetSize();
+        }
+    }
+
+    const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
+    GLsizei GetStride() const { return m_Stride; }
+
+private:
+    std::vector<VertexBufferElement> m_Elements;
+    GLsizei m_Stride;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "VertexBufferLayout.h"
+
+
+/**
+ * @brief how to get the original value back from the stored one, per 
+ * component: value = stored * Scale + Offset (what the vertex shader does 
+ * with the u_PosScale/u_PosOffset style uniforms)
+ */
+struct AttributeBounds {
+    float Offset[4];
+    float Scale[4];
+};
+
+struct QuantizationReport {
+    size_t SourceBytes;
+    size_t QuantizedBytes;
+    GLsizei SourceStride;
+    GLsizei QuantizedStride;
+};
+
+struct QuantizedVertices {
+    std::vector<uint8_t> Data;
+    VertexBufferLayout Layout;
+    std::vector<AttributeBounds> Bounds;    // one per layout element
+    QuantizationReport Report;
+};
+
+/**
+ * @brief convert float vertices to a compact format, element by element.
+ * 
+ * The target layout says which format each source element becomes:
+ * - GL_FLOAT: copied
+ * - GL_HALF_FLOAT: 16 bit floats
+ * - GL_SHORT/GL_BYTE normalized (snorm) and GL_UNSIGNED_SHORT/BYTE 
+ * normalized (unorm)
+ * - GL_INT_2_10_10_10_REV normalized, 4 components in 32 bits 
+ * (e.g. normals, w is set to 0 if the source has only 3)
+ * 
+ * Normalized formats only cover [-1, 1] ([0, 1] for unorm): components that 
+ * go outside (positions, tiling UVs) are remapped to the mesh bounds, 
+ * recorded in QuantizedVertices::Bounds for dequantization.
+ * 
+ * @param vertices interleaved floats described by source
+ * @param count number of vertices
+ * @param source layout of vertices, GL_FLOAT elements only
+ * @param target same number of elements as source, component count can 
+ * only grow (padding with 0)
+ */
+QuantizedVertices QuantizeVertices(const float* vertices, uint32_t count, 
+    const VertexBufferLayout& source, const VertexBufferLayout& target);
+
+/**
+ * @brief print memory saved and the expected vertex fetch gain
+ */
+void PrintQuantizationReport(const QuantizationReport& report);
+
+/**
+ * @brief IEEE 754 float -> half float bits, round to nearest even
+ */
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t half);
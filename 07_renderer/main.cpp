@@ -0,0 +1,503 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "BatchRenderer2D.h"
+#include "Bvh.h"
+#include "Debug.h"
+#include "Ecs.h"
+#include "IndexData.h"
+#include "InstanceRenderer.h"
+#include "MeshPool.h"
+#include "SceneComponents.h"
+#include "Shader.h"
+#include "StreamBuffer.h"
+#include "TransformHierarchy.h"
+#include "TripleBuffer.h"
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+
+// Function prototypes
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
+
+// Window dimensions
+const GLuint WIDTH = 800, HEIGHT = 600;
+
+// the simulation runs at a fixed rate on the main thread
+const double STEP = 1.0 / 60.0;
+
+// glfwGetTime() of the first input event not simulated yet, 0 for none. 
+// Written by the callbacks, on the main thread
+static double s_InputTime = 0.0;
+
+// what a simulation step hands to the render thread
+struct FrameSnapshot {
+    uint64_t Step;                  // 0: nothing simulated yet
+    double SimulatedTime;           // glfwGetTime() when the step ran
+    double InputTime;               // oldest input not presented yet, 0 for none
+    uint64_t Dropped;               // steps overwritten before being drawn, so far
+    float R;
+    std::vector<InstanceData> Grid; // the visible cells
+    std::vector<MeshPool::MeshHandle> StaticMeshes;
+
+    FrameSnapshot() : Step(0), SimulatedTime(0.0), InputTime(0.0), Dropped(0), R(0.0f) {}
+};
+
+
+// The MAIN function, from here we start the application and run the game loop
+int main()
+{
+    std::cout << "Starting GLFW context" << std::endl;
+    
+    // Init GLFW
+    if (!glfwInit())
+        return -1;
+
+    // Set all the required options for GLFW
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    // Create a GLFWwindow object that we can use for GLFW's functions
+    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Modern OpenGL", nullptr, nullptr);
+    glfwMakeContextCurrent(window);
+
+    glfwSwapInterval(1);
+
+    // Set the required callback functions
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+
+    // Set this to true so GLEW knows to use a modern approach to retrieving 
+    // function pointers and extensions
+    glewExperimental = GL_TRUE;
+    
+    // Initialize GLEW to setup the OpenGL Function pointers
+    GLenum err = glewInit();
+    if (err != GLEW_OK)
+        std::cout << "Error: " << glewGetErrorString(err) << std::endl;
+    else 
+        std::cout << "GLVersion: " << glGetString(GL_VERSION) << std::endl;
+    
+    // Define the viewport dimensions
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);  
+    glViewport(0, 0, width, height);
+
+
+
+    // GL objects have to be released before the context is destroyed, so 
+    // they live in this scope
+    {
+        //////// 2 TRIANGLES
+
+        GLfloat vertices[] = {
+             0.5f,  0.5f, 0.0f,  // Top Right
+             0.5f, -0.5f, 0.0f,  // Bottom Right
+            -0.5f, -0.5f, 0.0f,  // Bottom Left
+            -0.5f,  0.5f, 0.0f   // Top Left 
+        };
+        GLuint indices[] = {  // Note that we start from 0!
+            0, 1, 3,  // First Triangle
+            1, 2, 3   // Second Triangle
+        };
+        const GLsizei stride = 3 * sizeof(GLfloat);
+
+        // vertices are rewritten every frame, so they live in a ring buffer 
+        // instead of a GL_STATIC_DRAW vertex buffer
+        StreamBuffer stream(sizeof(vertices));
+
+        GLuint VAO, IBO;
+        GLCall( glGenVertexArrays(1, &VAO) ); // generate 1 vertex array 
+        GLCall( glGenBuffers(1, &IBO) ); // generate 1 index buffer
+
+        // Bind the Vertex Array Object first
+        GLCall( glBindVertexArray(VAO) );
+
+        // Select the stream buffer as vertex buffer, the frame offset is passed 
+        // later on as base vertex
+        GLCall( glBindBuffer(GL_ARRAY_BUFFER, stream.GetID()) );
+        // bind index 0 of vertex array with the currently bound GL_ARRAY_BUFFER
+        GLCall( glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)0) );
+        GLCall( glEnableVertexAttribArray(0) );
+
+        // Select index buffer
+        GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO) );
+        // 4 vertices: the indices fit in GL_UNSIGNED_BYTE, a quarter of the size
+        IndexData rectangleIndices = NarrowIndices(indices, 6);
+        GLCall( glBufferData(GL_ELEMENT_ARRAY_BUFFER, rectangleIndices.Bytes.size(), 
+            rectangleIndices.Bytes.data(), GL_STATIC_DRAW) );
+
+        // Unbind
+        GLCall( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+        GLCall( glBindVertexArray(0) ); // remember: do NOT unbind the EBO, keep it bound to this VAO
+
+
+        //////// STATIC MESHES
+
+        // static geometry goes in the mesh pool: every mesh shares the same 
+        // big VBO/IBO and VAO, no rebind between the draws
+        VertexBufferLayout layout;
+        layout.Push(GL_FLOAT, 3);
+        MeshPool meshPool(layout);
+
+        GLfloat triangle[] = {
+            -0.9f,  0.9f, 0.0f,
+            -0.9f,  0.6f, 0.0f,
+            -0.6f,  0.9f, 0.0f
+        };
+        GLuint triangleIndices[] = { 0, 1, 2 };
+        GLfloat square[] = {
+             0.9f, -0.6f, 0.0f,
+             0.9f, -0.9f, 0.0f,
+             0.6f, -0.9f, 0.0f,
+             0.6f, -0.6f, 0.0f
+        };
+        // the scene objects are entities, the renderer queries their components
+        World scene;
+        scene.Create(MeshComponent{ meshPool.Add(triangle, 3, triangleIndices, 3) });
+        scene.Create(MeshComponent{ meshPool.Add(square, 4, indices, 6) });
+        // records the draws of the pool meshes, submitted in a single call
+        DrawCommandBuilder drawCommands;
+
+
+        //////// INSTANCES
+
+        // a grid of small rectangles, one glDrawElementsInstanced for all of 
+        // them: transform and color come from a per instance buffer
+        const uint32_t gridSide = 100;
+        GLuint instanceVAO, instanceVBO, instanceIBO;
+        GLCall( glGenVertexArrays(1, &instanceVAO) );
+        GLCall( glGenBuffers(1, &instanceVBO) );
+        GLCall( glGenBuffers(1, &instanceIBO) );
+        GLCall( glBindVertexArray(instanceVAO) );
+        GLCall( glBindBuffer(GL_ARRAY_BUFFER, instanceVBO) );
+        GLCall( glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW) );
+        layout.Apply();
+        GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, instanceIBO) );
+        GLCall( glBufferData(GL_ELEMENT_ARRAY_BUFFER, rectangleIndices.Bytes.size(), 
+            rectangleIndices.Bytes.data(), GL_STATIC_DRAW) );
+        GLCall( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+        GLCall( glBindVertexArray(0) );
+
+        InstanceRenderer instances(instanceVAO, 1, gridSide * gridSide);
+
+        // the grid is twice the size of the screen and scrolls, the instances 
+        // are in a BVH: only the ones inside the view are written and drawn, 
+        // and a click picks one with a ray
+        ShaderProgramSource instancedSource = parseShader("../res/shaders/Instanced.shader");
+        GLuint instancedProgram = CreateShader(instancedSource.VertexShader, instancedSource.FragmentShader);
+
+        // the cells are children of the grid node, which scrolls: their world 
+        // matrices come from the transform hierarchy
+        TransformHierarchy transforms;
+        const float identity[16] = { 1.0f, 0.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f,  0.0f, 0.0f, 0.0f, 1.0f };
+        TransformHierarchy::Node gridNode = transforms.Add(identity);
+
+        const float cellSize = 4.0f / gridSide;
+        std::vector<Aabb> cellBounds(gridSide * gridSide);
+        std::vector<Entity> cells(gridSide * gridSide);
+        std::vector<TransformHierarchy::Node> cellNodes(gridSide * gridSide);
+        for (uint32_t i = 0; i < gridSide * gridSide; i++) {
+            float x = -2.0f + cellSize * (i % gridSide + 0.5f), y = -2.0f + cellSize * (i / gridSide + 0.5f);
+            cellBounds[i] = { { x - cellSize * 0.25f, y - cellSize * 0.25f, 0.0f }, 
+                { x + cellSize * 0.25f, y + cellSize * 0.25f, 0.0f } };
+            TransformComponent transform = { { x, y, 0.0f }, { cellSize * 0.5f, cellSize * 0.5f, 1.0f } };
+            cells[i] = scene.Create(transform, MaterialComponent{ (uint16_t)instancedProgram, 0, 0 });
+            float local[16];
+            transform.ToMatrix(local);
+            cellNodes[i] = transforms.Add(local, gridNode);
+        }
+        Bvh sceneBvh;
+        sceneBvh.Build(cellBounds.data(), cellBounds.size());
+        uint32_t picked = Bvh::Null;
+        std::vector<uint32_t> visibleInstances;
+        std::vector<TransformHierarchy::Node> visibleNodes;
+
+
+        //////// BATCH 2D
+
+        // UI like content: lots of small quads and triangles, a handful of 
+        // draw calls
+        BatchRenderer2D batch;
+        bool batchStatsPrinted = false;
+
+
+        ShaderProgramSource source = parseShader("../res/shaders/Basic.shader");
+        // // Create the shader program from the shader sources
+        GLuint shaderProgram = CreateShader(source.VertexShader, source.FragmentShader);
+        GLCall( glUseProgram(shaderProgram) );
+
+        // I retrieve the location of the color variable
+        GLCall( int location = glGetUniformLocation(shaderProgram, "u_Color") );
+        ASSERT(location != -1);
+        // once I have the location I set my data in my shader
+        GLCall( glUniform4f(location, 0.8f, 0.3f, 0.8f, 1.0f) );
+
+
+        // Uncommenting this call will result in wireframe polygons.
+        //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+        // the render thread owns the context from here on: it draws the 
+        // newest snapshot at its own pace while the main thread polls the 
+        // input and simulates, a slow frame on one side doesn't stall the other
+        TripleBuffer<FrameSnapshot> snapshots;
+        std::atomic<uint64_t> presentedStep(0);
+        std::atomic<bool> quit(false);
+        glfwMakeContextCurrent(nullptr);
+
+        std::thread renderThread([&]() {
+            glfwMakeContextCurrent(window);
+            glfwSwapInterval(1);
+
+            // latency stats, printed every few seconds
+            double reportTime = glfwGetTime(), lastInputTime = 0.0;
+            double ageTotal = 0.0, latencyTotal = 0.0, latencyMax = 0.0;
+            uint32_t presented = 0, inputs = 0, stepsShown = 0;
+
+            while (!quit.load(std::memory_order_relaxed))
+            {
+                bool fresh = snapshots.Acquire();
+                const FrameSnapshot& frame = snapshots.GetRead();
+                if (!frame.Step) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                float r = frame.R;
+
+                // Clear the colorbuffer
+                GLCall( glClearColor(0.1f, 0.1f, 0.1f, 1.0f) );
+                GLCall( glClear(GL_COLOR_BUFFER_BIT) );
+
+
+
+                // INSTANCES
+                GLCall( glUseProgram(instancedProgram) );
+                InstanceData* grid = instances.Begin((uint32_t)frame.Grid.size());
+                std::copy(frame.Grid.begin(), frame.Grid.end(), grid);
+                instances.Draw(6, rectangleIndices.Type);
+                GLCall( glBindVertexArray(0) );
+                instances.EndFrame();
+                GLCall( glUseProgram(shaderProgram) );
+
+
+
+                // BATCH 2D
+                batch.Begin();
+                for (int i = 0; i < 40; i++) {
+                    for (int j = 0; j < 4; j++) {
+                        float x = -0.95f + i * 0.0475f, y = -0.95f + j * 0.03f;
+                        float color[4] = { 0.9f, 0.9f * r, (float)j / 4.0f, 1.0f };
+                        batch.DrawQuad(x, y, 0.04f, 0.025f, color);
+                    }
+                    float p0[2] = { -0.95f + i * 0.0475f, 0.85f };
+                    float p1[2] = { p0[0] + 0.04f, 0.85f };
+                    float p2[2] = { p0[0] + 0.02f, 0.85f + 0.04f * r };
+                    float color[4] = { 0.3f, 0.9f, 0.3f, 1.0f };
+                    batch.DrawTriangle(p0, p1, p2, color);
+                }
+                batch.End();
+                if (!batchStatsPrinted) {
+                    std::cout << "Batch: " << batch.GetStats().Quads << " quads in " 
+                        << batch.GetStats().DrawCalls << " draw calls" << std::endl;
+                    batchStatsPrinted = true;
+                }
+                GLCall( glUseProgram(shaderProgram) );
+
+
+
+                // 2 TRIENGLES
+                // allocate, write straight into the mapped memory, then draw at the 
+                // allocation offset
+                StreamBuffer::Allocation vertexData = stream.Allocate(sizeof(vertices), stride);
+                GLfloat* dst = (GLfloat*)vertexData.Data;
+                for (int i = 0; i < 12; i++)
+                    dst[i] = vertices[i] * (0.5f + 0.5f * r);
+                stream.Commit(vertexData);
+
+                GLCall( glBindVertexArray(VAO) );
+
+                // once I have the location I set my data in my shader
+                GLCall( glUniform4f(location, r, 0.3f, 0.8f, 1.0f) );
+                GLCall( glDrawElementsBaseVertex(GL_TRIANGLES, 6, rectangleIndices.Type, 0, 
+                    (GLint)(vertexData.Offset / stride)) );
+
+                GLCall( glBindVertexArray(0) ); // unbind
+
+                GLCall( glUniform4f(location, 0.3f, 0.8f, r, 1.0f) );
+                meshPool.DrawMulti(frame.StaticMeshes.data(), (uint32_t)frame.StaticMeshes.size(), drawCommands);
+                meshPool.Unbind();
+                meshPool.Defragment();
+                // fence the vertices we just used
+                stream.EndFrame();
+
+
+
+                // Swap the screen buffers
+                GLCall( glfwSwapBuffers(window) );
+
+                // a snapshot drawn again (the simulation is late) shows 
+                // nothing new, only the first present counts
+                double now = glfwGetTime();
+                presented++;
+                if (fresh) {
+                    stepsShown++;
+                    ageTotal += now - frame.SimulatedTime;
+                    if (frame.InputTime > 0.0 && frame.InputTime != lastInputTime) {
+                        inputs++;
+                        latencyTotal += now - frame.InputTime;
+                        latencyMax = std::max(latencyMax, now - frame.InputTime);
+                        lastInputTime = frame.InputTime;
+                    }
+                    presentedStep.store(frame.Step, std::memory_order_relaxed);
+                }
+
+                if (now - reportTime >= 5.0) {
+                    std::cout << "Render: " << presented / (now - reportTime) << " fps, " << stepsShown 
+                        << " steps shown, " << frame.Dropped << " dropped so far, frame age " 
+                        << (stepsShown ? ageTotal / stepsShown * 1000.0 : 0.0) << " ms";
+                    if (inputs) {
+                        std::cout << ", input to present " << latencyTotal / inputs * 1000.0 << " ms (max " 
+                            << latencyMax * 1000.0 << " ms, " << inputs << " inputs)";
+                    }
+                    std::cout << std::endl;
+                    reportTime = now;
+                    ageTotal = latencyTotal = latencyMax = 0.0;
+                    presented = inputs = stepsShown = 0;
+                }
+            }
+            glfwMakeContextCurrent(nullptr);
+        });
+
+        float r = 0.0f;
+        float increment = 0.05f;
+        uint64_t step = 0, dropped = 0;
+        // the oldest input not presented yet, and the first step showing it
+        double pendingInput = 0.0;
+        uint64_t pendingStep = 0;
+        double nextStep = glfwGetTime();
+
+        // Game loop
+        while (!glfwWindowShouldClose(window))
+        {
+            // Wait for the next step, the events (key pressed, mouse moved etc.) 
+            // call the corresponding response functions as they come
+            glfwWaitEventsTimeout(std::max(0.0, nextStep - glfwGetTime()));
+            double now = glfwGetTime();
+            if (now < nextStep)
+                continue;
+            // after a stall, go on from now instead of catching up
+            nextStep = std::max(nextStep + STEP, now);
+            step++;
+
+            if (pendingInput > 0.0 && presentedStep.load(std::memory_order_relaxed) >= pendingStep)
+                pendingInput = 0.0;
+            if (s_InputTime > 0.0 && pendingInput == 0.0) {
+                pendingInput = s_InputTime;
+                pendingStep = step;
+            }
+            s_InputTime = 0.0;
+
+            FrameSnapshot& frame = snapshots.GetWrite();
+            frame.Step = step;
+            frame.SimulatedTime = now;
+            frame.InputTime = pendingInput;
+            frame.R = r;
+
+
+
+            // INSTANCES
+            float pan = (r - 0.5f) * 2.0f;
+            float view[16] = { 1.0f, 0.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f,  -pan, 0.0f, 0.0f, 1.0f };
+            sceneBvh.Cull(Frustum::FromMatrix(view), visibleInstances);
+
+            if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
+                double cursorX, cursorY;
+                int windowWidth, windowHeight;
+                glfwGetCursorPos(window, &cursorX, &cursorY);
+                glfwGetWindowSize(window, &windowWidth, &windowHeight);
+                // from the cursor, straight into the screen
+                float origin[3] = { (float)(cursorX / windowWidth * 2.0 - 1.0) + pan, 
+                    (float)(1.0 - cursorY / windowHeight * 2.0), 1.0f };
+                float direction[3] = { 0.0f, 0.0f, -1.0f };
+                picked = sceneBvh.Raycast(origin, direction, 2.0f);
+            }
+            // the colors follow r, from left to right
+            scene.ParallelEach<TransformComponent, MaterialComponent>(
+                [r](Entity, const TransformComponent& transform, MaterialComponent& material) {
+                    float column = (transform.Position[0] + 2.0f) / 4.0f;
+                    material.Color = InstanceRenderer::PackColor(0.2f, r * column, 0.4f, 1.0f);
+                });
+
+            transforms.SetLocal(gridNode, view);
+            transforms.Update();
+            visibleNodes.resize(visibleInstances.size());
+            for (size_t v = 0; v < visibleInstances.size(); v++)
+                visibleNodes[v] = cellNodes[visibleInstances[v]];
+
+            frame.Grid.resize(visibleInstances.size());
+            transforms.WriteInstances(visibleNodes.data(), visibleNodes.size(), frame.Grid.data());
+            for (size_t v = 0; v < visibleInstances.size(); v++) {
+                uint32_t i = visibleInstances[v];
+                frame.Grid[v].Color = i == picked ? InstanceRenderer::PackColor(1.0f, 1.0f, 1.0f, 1.0f) : 
+                    scene.Get<MaterialComponent>(cells[i])->Color;
+            }
+
+            frame.StaticMeshes.clear();
+            scene.Each<MeshComponent>([&frame](Entity, const MeshComponent& mesh) { 
+                frame.StaticMeshes.push_back(mesh.Mesh); 
+            });
+
+            if (r > 1.0f)
+                increment = -0.05f;
+            else if (r < 0.0f)
+                increment = 0.05f;
+
+            r += increment;
+
+            frame.Dropped = dropped;
+            if (snapshots.Publish())
+                dropped++;
+        }
+        quit = true;
+        renderThread.join();
+        glfwMakeContextCurrent(window);
+
+        // Properly de-allocate all resources once they've outlived their purpose
+        GLCall( glDeleteVertexArrays(1, &VAO) );
+        GLCall( glDeleteBuffers(1, &IBO) );
+        GLCall( glDeleteVertexArrays(1, &instanceVAO) );
+        GLCall( glDeleteBuffers(1, &instanceVBO) );
+        GLCall( glDeleteBuffers(1, &instanceIBO) );
+        GLCall( glDeleteProgram(instancedProgram) );
+        GLCall( glDeleteProgram(shaderProgram) );
+    }
+
+    // Terminate GLFW, clearing any resources allocated by GLFW.
+    glfwTerminate() ;
+    return 0;
+}
+
+// Is called whenever a key is pressed/released via GLFW
+void key_callback(GLFWwindow* window, int key, int, int action, int)
+{
+    if (s_InputTime == 0.0)
+        s_InputTime = glfwGetTime();
+    if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, GL_TRUE);
+}
+
+// Is called whenever a mouse button is pressed/released via GLFW
+void mouse_button_callback(GLFWwindow*, int, int, int)
+{
+    if (s_InputTime == 0.0)
+        s_InputTime = glfwGetTime();
+}
@@ -0,0 +1,30 @@
+#shader vertex
+#version 330 core
+
+layout (location = 0) in vec4 position;
+// per instance (glVertexAttribDivisor 1)
+layout (location = 1) in vec4 i_Row0;
+layout (location = 2) in vec4 i_Row1;
+layout (location = 3) in vec4 i_Row2;
+layout (location = 4) in vec4 i_Color;
+
+out vec4 v_Color;
+
+void main()
+{
+    vec4 p = vec4(position.xyz, 1.0);
+    gl_Position = vec4(dot(i_Row0, p), dot(i_Row1, p), dot(i_Row2, p), 1.0);
+    v_Color = i_Color;
+}
+
+#shader fragment
+#version 330 core
+
+layout (location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+    color = v_Color;
+}
@@ -0,0 +1,27 @@
+#shader vertex
+#version 330 core
+
+layout (location = 0) in vec4 position;
+
+// same transform and color as Instanced.shader, set per draw
+uniform vec4 u_Row0;
+uniform vec4 u_Row1;
+uniform vec4 u_Row2;
+
+void main()
+{
+    vec4 p = vec4(position.xyz, 1.0);
+    gl_Position = vec4(dot(u_Row0, p), dot(u_Row1, p), dot(u_Row2, p), 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout (location = 0) out vec4 color;
+
+uniform vec4 u_Color;
+
+void main()
+{
+    color = u_Color;
+}
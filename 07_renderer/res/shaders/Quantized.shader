@@ -0,0 +1,30 @@
+#shader vertex
+#version 330 core
+
+layout (location = 0) in vec4 position;
+layout (location = 1) in vec4 normal;
+layout (location = 2) in vec2 texCoord;
+
+// dequantization: position = stored * scale + offset
+uniform vec3 u_PosScale;
+uniform vec3 u_PosOffset;
+
+out vec3 v_Color;
+
+void main()
+{
+    v_Color = (normal.xyz * 0.5 + 0.5) * vec3(texCoord, 1.0);
+    gl_Position = vec4(position.xyz * u_PosScale + u_PosOffset, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout (location = 0) out vec4 color;
+
+in vec3 v_Color;
+
+void main()
+{
+    color = vec4(v_Color, 1.0);
+}
@@ -0,0 +1,159 @@
+#include "BatchRenderer2D.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "InstanceRenderer.h"
+#include "Shader.h"
+#include "VertexBufferLayout.h"
+
+
+BatchRenderer2D::BatchRenderer2D(uint32_t maxQuads)
+    : m_MaxQuads(std::min(maxQuads, 16384u)), m_VAO(0), m_IBO(0), m_WhiteTexture(0), m_Program(0),
+      m_Stream((GLsizeiptr)m_MaxQuads * 4 * sizeof(BatchVertex)), m_TextureCount(1), m_Stats{0, 0} {
+
+    // every batch uses the same quad pattern, computed once
+    std::vector<GLuint> indices(m_MaxQuads * 6);
+    for (uint32_t quad = 0; quad < m_MaxQuads; quad++) {
+        GLuint first = quad * 4;
+        GLuint pattern[6] = { first, first + 1, first + 2, first + 2, first + 3, first };
+        memcpy(&indices[quad * 6], pattern, sizeof(pattern));
+    }
+    m_QuadIndices = NarrowIndices(indices.data(), (uint32_t)indices.size());
+
+    VertexBufferLayout layout;
+    layout.Push(GL_FLOAT, 3);
+    layout.Push(GL_UNSIGNED_BYTE, 4, GL_TRUE);
+    layout.Push(GL_FLOAT, 2);
+    layout.Push(GL_FLOAT, 1);
+    ASSERT(layout.GetStride() == sizeof(BatchVertex));
+
+    GLCall( glGenVertexArrays(1, &m_VAO) );
+    GLCall( glGenBuffers(1, &m_IBO) );
+    GLCall( glBindVertexArray(m_VAO) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, m_Stream.GetID()) );
+    layout.Apply();
+    GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IBO) );
+    GLCall( glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_QuadIndices.Bytes.size(), m_QuadIndices.Bytes.data(), 
+        GL_STATIC_DRAW) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+    GLCall( glBindVertexArray(0) );
+
+    // slot 0: 1x1 white texture, so untextured quads go in the same batch
+    uint32_t white = 0xFFFFFFFF;
+    GLCall( glGenTextures(1, &m_WhiteTexture) );
+    GLCall( glBindTexture(GL_TEXTURE_2D, m_WhiteTexture) );
+    GLCall( glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &white) );
+    GLCall( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST) );
+    GLCall( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST) );
+    GLCall( glBindTexture(GL_TEXTURE_2D, 0) );
+    m_Textures[0] = m_WhiteTexture;
+
+    ShaderProgramSource source = parseShader("../res/shaders/Batch.shader");
+    m_Program = CreateShader(source.VertexShader, source.FragmentShader);
+    GLCall( glUseProgram(m_Program) );
+    GLint samplers[MaxTextureSlots];
+    for (uint32_t i = 0; i < MaxTextureSlots; i++)
+        samplers[i] = (GLint)i;
+    GLCall( GLint location = glGetUniformLocation(m_Program, "u_Textures") );
+    GLCall( glUniform1iv(location, MaxTextureSlots, samplers) );
+    GLCall( glUseProgram(0) );
+
+    m_Staging.reserve(m_MaxQuads * 4);
+}
+
+BatchRenderer2D::~BatchRenderer2D() {
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteBuffers(1, &m_IBO);
+    glDeleteTextures(1, &m_WhiteTexture);
+    glDeleteProgram(m_Program);
+}
+
+void BatchRenderer2D::Begin() {
+    m_Stats = {0, 0};
+    m_Staging.clear();
+    m_TextureCount = 1;
+}
+
+void BatchRenderer2D::End() {
+    Flush();
+    m_Stream.EndFrame();
+}
+
+void BatchRenderer2D::Flush() {
+    if (m_Staging.empty())
+        return;
+
+    GLsizei quads = (GLsizei)(m_Staging.size() / 4);
+    GLsizeiptr size = (GLsizeiptr)(m_Staging.size() * sizeof(BatchVertex));
+
+    // staging -> ring buffer, drawn at the allocation as base vertex
+    StreamBuffer::Allocation allocation = m_Stream.Allocate(size, sizeof(BatchVertex));
+    memcpy(allocation.Data, m_Staging.data(), size);
+    m_Stream.Commit(allocation);
+
+    GLCall( glUseProgram(m_Program) );
+    for (uint32_t slot = 0; slot < m_TextureCount; slot++) {
+        GLCall( glActiveTexture(GL_TEXTURE0 + slot) );
+        GLCall( glBindTexture(GL_TEXTURE_2D, m_Textures[slot]) );
+    }
+    GLCall( glBindVertexArray(m_VAO) );
+    GLCall( glDrawElementsBaseVertex(GL_TRIANGLES, quads * 6, m_QuadIndices.Type, 0, 
+        (GLint)(allocation.Offset / sizeof(BatchVertex))) );
+    GLCall( glBindVertexArray(0) );
+    GLCall( glActiveTexture(GL_TEXTURE0) );
+
+    m_Stats.DrawCalls++;
+    m_Staging.clear();
+    m_TextureCount = 1;
+}
+
+float BatchRenderer2D::TextureSlot(GLuint texture) {
+    for (uint32_t slot = 0; slot < m_TextureCount; slot++)
+        if (m_Textures[slot] == texture)
+            return (float)slot;
+
+    if (m_TextureCount == MaxTextureSlots)
+        Flush();
+    m_Textures[m_TextureCount] = texture;
+    return (float)m_TextureCount++;
+}
+
+void BatchRenderer2D::PushVertex(float x, float y, uint32_t color, float u, float v, float slot) {
+    m_Staging.push_back({{x, y, 0.0f}, color, {u, v}, slot});
+}
+
+void BatchRenderer2D::DrawQuad(float x, float y, float width, float height, const float color[4]) {
+    DrawQuad(x, y, width, height, m_WhiteTexture, color);
+}
+
+void BatchRenderer2D::DrawQuad(float x, float y, float width, float height, GLuint texture, 
+    const float tint[4]) {
+
+    if (m_Staging.size() == m_MaxQuads * 4)
+        Flush();
+    // the slot is resolved after the capacity check, a flush resets them
+    float slot = TextureSlot(texture);
+    uint32_t color = InstanceRenderer::PackColor(tint[0], tint[1], tint[2], tint[3]);
+
+    PushVertex(x, y, color, 0.0f, 0.0f, slot);
+    PushVertex(x + width, y, color, 1.0f, 0.0f, slot);
+    PushVertex(x + width, y + height, color, 1.0f, 1.0f, slot);
+    PushVertex(x, y + height, color, 0.0f, 1.0f, slot);
+    m_Stats.Quads++;
+}
+
+void BatchRenderer2D::DrawTriangle(const float p0[2], const float p1[2], const float p2[2], 
+    const float color[4]) {
+
+    if (m_Staging.size() == m_MaxQuads * 4)
+        Flush();
+    uint32_t packed = InstanceRenderer::PackColor(color[0], color[1], color[2], color[3]);
+
+    PushVertex(p0[0], p0[1], packed, 0.0f, 0.0f, 0.0f);
+    PushVertex(p1[0], p1[1], packed, 0.0f, 0.0f, 0.0f);
+    PushVertex(p2[0], p2[1], packed, 0.0f, 0.0f, 0.0f);
+    PushVertex(p2[0], p2[1], packed, 0.0f, 0.0f, 0.0f); // degenerate second triangle
+    m_Stats.Quads++;
+}
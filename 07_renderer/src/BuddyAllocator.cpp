@@ -0,0 +1,119 @@
+#include "BuddyAllocator.h"
+
+
+BuddyAllocator::BuddyAllocator(uint32_t capacity, uint32_t minBlockSize)
+    : m_MinBlockSize(minBlockSize), m_MaxOrder(0), m_Used(0) {
+
+    while (BlockSize(m_MaxOrder) < capacity)
+        m_MaxOrder++;
+
+    m_FreeLists.resize(m_MaxOrder + 1);
+    m_FreeLists[m_MaxOrder].insert(0);
+}
+
+uint32_t BuddyAllocator::OrderFor(uint32_t size) const {
+    uint32_t order = 0;
+    while (BlockSize(order) < size)
+        order++;
+    return order;
+}
+
+uint32_t BuddyAllocator::AllocateOrder(uint32_t order, bool lowestAddress) {
+    // pick the free block to split: the smallest one that fits, or the one 
+    // with the lowest offset (used while defragmenting)
+    uint32_t found = m_MaxOrder + 1;
+    for (uint32_t k = order; k <= m_MaxOrder; k++) {
+        if (m_FreeLists[k].empty())
+            continue;
+        if (found > m_MaxOrder || *m_FreeLists[k].begin() < *m_FreeLists[found].begin())
+            found = k;
+        if (!lowestAddress)
+            break;
+    }
+    if (found > m_MaxOrder)
+        return InvalidOffset;
+
+    uint32_t offset = *m_FreeLists[found].begin();
+    m_FreeLists[found].erase(m_FreeLists[found].begin());
+
+    // split down, the upper halves go back to the free lists
+    while (found > order) {
+        found--;
+        m_FreeLists[found].insert(offset + BlockSize(found));
+    }
+
+    m_Allocated[offset] = order;
+    m_Used += BlockSize(order);
+    return offset;
+}
+
+uint32_t BuddyAllocator::Allocate(uint32_t size) {
+    if (size == 0 || size > GetCapacity())
+        return InvalidOffset;
+    return AllocateOrder(OrderFor(size), false);
+}
+
+void BuddyAllocator::Free(uint32_t offset) {
+    auto it = m_Allocated.find(offset);
+    if (it == m_Allocated.end())
+        return;
+
+    uint32_t order = it->second;
+    m_Allocated.erase(it);
+    m_Used -= BlockSize(order);
+
+    // merge with the buddy as long as it is free
+    while (order < m_MaxOrder) {
+        uint32_t buddy = offset ^ BlockSize(order);
+        auto free = m_FreeLists[order].find(buddy);
+        if (free == m_FreeLists[order].end())
+            break;
+        m_FreeLists[order].erase(free);
+        offset = offset < buddy ? offset : buddy;
+        order++;
+    }
+    m_FreeLists[order].insert(offset);
+}
+
+std::vector<BuddyAllocator::Move> BuddyAllocator::Defragment(uint32_t maxMoves) {
+    std::vector<Move> moves;
+
+    // walk the allocations from the top, each one goes into the lowest free 
+    // block that fits if that is below its current offset
+    uint32_t cursor = InvalidOffset;
+    while (moves.size() < maxMoves) {
+        auto it = m_Allocated.lower_bound(cursor);
+        if (it == m_Allocated.begin())
+            break;
+        --it;
+
+        uint32_t from = it->first;
+        uint32_t order = it->second;
+        cursor = from;
+
+        uint32_t to = AllocateOrder(order, true);
+        if (to == InvalidOffset)
+            continue;
+
+        if (to < from) {
+            moves.push_back({from, to, BlockSize(order)});
+            Free(from);
+        } else {
+            Free(to);
+        }
+    }
+
+    return moves;
+}
+
+uint32_t BuddyAllocator::GetBlockSize(uint32_t offset) const {
+    auto it = m_Allocated.find(offset);
+    return it == m_Allocated.end() ? 0 : BlockSize(it->second);
+}
+
+uint32_t BuddyAllocator::GetHighWatermark() const {
+    if (m_Allocated.empty())
+        return 0;
+    auto last = m_Allocated.rbegin();
+    return last->first + BlockSize(last->second);
+}
@@ -0,0 +1,416 @@
+#include "Bvh.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+// centroid bins per axis evaluated by the SAH build
+static const int SAH_BINS = 16;
+
+static Aabb EmptyAabb() {
+    return { { INFINITY, INFINITY, INFINITY }, { -INFINITY, -INFINITY, -INFINITY } };
+}
+
+uint32_t Bvh::AllocateNode() {
+    uint32_t node;
+    if (m_FreeList != Null) {
+        node = m_FreeList;
+        m_FreeList = m_Nodes[node].UserData;
+    } else {
+        node = (uint32_t)m_Nodes.size();
+        m_Nodes.emplace_back();
+    }
+    m_Nodes[node].Parent = Null;
+    m_Nodes[node].Children[0] = m_Nodes[node].Children[1] = Null;
+    m_Nodes[node].UserData = Null;
+    return node;
+}
+
+void Bvh::FreeNode(uint32_t node) {
+    m_Nodes[node].UserData = m_FreeList;
+    m_FreeList = node;
+}
+
+void Bvh::Clear() {
+    m_Nodes.clear();
+    m_Root = Null;
+    m_FreeList = Null;
+    m_LeafCount = 0;
+}
+
+void Bvh::Build(const Aabb* bounds, size_t count, const uint32_t* userData, uint32_t* proxies) {
+    Clear();
+    if (count == 0)
+        return;
+    m_Nodes.reserve(count * 2 - 1);
+
+    // the leaves first, node i is object i
+    std::vector<uint32_t> leaves(count);
+    std::vector<float> centroids(count * 3);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t leaf = AllocateNode();
+        m_Nodes[leaf].Bounds = bounds[i];
+        m_Nodes[leaf].UserData = userData ? userData[i] : (uint32_t)i;
+        leaves[i] = leaf;
+        for (int axis = 0; axis < 3; axis++)
+            centroids[i * 3 + axis] = (bounds[i].Min[axis] + bounds[i].Max[axis]) * 0.5f;
+        if (proxies)
+            proxies[i] = leaf;
+    }
+    m_LeafCount = count;
+    m_Root = BuildRecursive(leaves.data(), centroids.data(), count, Null);
+}
+
+uint32_t Bvh::BuildRecursive(uint32_t* leaves, const float* centroids, size_t count, uint32_t parent) {
+    if (count == 1) {
+        m_Nodes[leaves[0]].Parent = parent;
+        return leaves[0];
+    }
+
+    float min[3] = { INFINITY, INFINITY, INFINITY }, max[3] = { -INFINITY, -INFINITY, -INFINITY };
+    for (size_t i = 0; i < count; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            min[axis] = std::min(min[axis], centroids[leaves[i] * 3 + axis]);
+            max[axis] = std::max(max[axis], centroids[leaves[i] * 3 + axis]);
+        }
+    }
+
+    // SAH over the bins of every axis: count * area on both sides
+    float bestCost = INFINITY;
+    int bestAxis = -1, bestSplit = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        float extent = max[axis] - min[axis];
+        if (extent <= 0.0f)
+            continue;
+        float scale = SAH_BINS / extent;
+
+        Aabb binBounds[SAH_BINS];
+        size_t binCounts[SAH_BINS] = {};
+        for (int b = 0; b < SAH_BINS; b++)
+            binBounds[b] = EmptyAabb();
+        for (size_t i = 0; i < count; i++) {
+            int b = std::min(SAH_BINS - 1, (int)((centroids[leaves[i] * 3 + axis] - min[axis]) * scale));
+            binCounts[b]++;
+            binBounds[b] = Aabb::Union(binBounds[b], m_Nodes[leaves[i]].Bounds);
+        }
+
+        // right side areas from the top, then sweep from the bottom
+        float rightCost[SAH_BINS];
+        Aabb right = EmptyAabb();
+        size_t rightCount = 0;
+        for (int b = SAH_BINS - 1; b > 0; b--) {
+            right = Aabb::Union(right, binBounds[b]);
+            rightCount += binCounts[b];
+            rightCost[b] = rightCount ? rightCount * right.SurfaceArea() : 0.0f;
+        }
+        Aabb left = EmptyAabb();
+        size_t leftCount = 0;
+        for (int b = 1; b < SAH_BINS; b++) {
+            left = Aabb::Union(left, binBounds[b - 1]);
+            leftCount += binCounts[b - 1];
+            if (leftCount == 0 || leftCount == count)
+                continue;
+            float cost = leftCount * left.SurfaceArea() + rightCost[b];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b;
+            }
+        }
+    }
+
+    size_t middle;
+    if (bestAxis >= 0) {
+        float scale = SAH_BINS / (max[bestAxis] - min[bestAxis]);
+        uint32_t* split = std::partition(leaves, leaves + count, [&](uint32_t leaf) {
+            int b = std::min(SAH_BINS - 1, (int)((centroids[leaf * 3 + bestAxis] - min[bestAxis]) * scale));
+            return b < bestSplit;
+        });
+        middle = split - leaves;
+    } else {
+        // every centroid at the same place, any split is as good
+        middle = count / 2;
+    }
+
+    uint32_t node = AllocateNode();
+    m_Nodes[node].Parent = parent;
+    uint32_t first = BuildRecursive(leaves, centroids, middle, node);
+    uint32_t second = BuildRecursive(leaves + middle, centroids, count - middle, node);
+    m_Nodes[node].Children[0] = first;
+    m_Nodes[node].Children[1] = second;
+    m_Nodes[node].Bounds = Aabb::Union(m_Nodes[first].Bounds, m_Nodes[second].Bounds);
+    return node;
+}
+
+uint32_t Bvh::Insert(const Aabb& bounds, uint32_t userData) {
+    uint32_t leaf = AllocateNode();
+    m_Nodes[leaf].Bounds = bounds;
+    m_Nodes[leaf].UserData = userData;
+    m_LeafCount++;
+
+    if (m_Root == Null) {
+        m_Root = leaf;
+        return leaf;
+    }
+
+    // go down while a child is a cheaper sibling than the node itself: the 
+    // new parent costs the combined area, every ancestor grows too
+    uint32_t sibling = m_Root;
+    while (!m_Nodes[sibling].IsLeaf()) {
+        const Node& node = m_Nodes[sibling];
+        float area = node.Bounds.SurfaceArea();
+        float combined = Aabb::Union(node.Bounds, bounds).SurfaceArea();
+        float cost = 2.0f * combined;
+        float inheritance = 2.0f * (combined - area);
+
+        float childCost[2];
+        for (int c = 0; c < 2; c++) {
+            const Node& child = m_Nodes[node.Children[c]];
+            float grown = Aabb::Union(child.Bounds, bounds).SurfaceArea();
+            childCost[c] = (child.IsLeaf() ? grown : grown - child.Bounds.SurfaceArea()) + inheritance;
+        }
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+        sibling = node.Children[childCost[0] < childCost[1] ? 0 : 1];
+    }
+
+    uint32_t oldParent = m_Nodes[sibling].Parent;
+    uint32_t newParent = AllocateNode();
+    m_Nodes[newParent].Parent = oldParent;
+    m_Nodes[newParent].Children[0] = sibling;
+    m_Nodes[newParent].Children[1] = leaf;
+    m_Nodes[newParent].Bounds = Aabb::Union(m_Nodes[sibling].Bounds, bounds);
+    m_Nodes[sibling].Parent = newParent;
+    m_Nodes[leaf].Parent = newParent;
+
+    if (oldParent == Null) {
+        m_Root = newParent;
+    } else {
+        Node& parent = m_Nodes[oldParent];
+        parent.Children[parent.Children[0] == sibling ? 0 : 1] = newParent;
+        RefitAncestors(oldParent);
+    }
+    return leaf;
+}
+
+void Bvh::Remove(uint32_t proxy) {
+    m_LeafCount--;
+    if (proxy == m_Root) {
+        m_Root = Null;
+        FreeNode(proxy);
+        return;
+    }
+
+    // the sibling takes the place of the parent
+    uint32_t parent = m_Nodes[proxy].Parent;
+    uint32_t grandParent = m_Nodes[parent].Parent;
+    uint32_t sibling = m_Nodes[parent].Children[m_Nodes[parent].Children[0] == proxy ? 1 : 0];
+    m_Nodes[sibling].Parent = grandParent;
+    if (grandParent == Null) {
+        m_Root = sibling;
+    } else {
+        Node& node = m_Nodes[grandParent];
+        node.Children[node.Children[0] == parent ? 0 : 1] = sibling;
+        RefitAncestors(grandParent);
+    }
+    FreeNode(parent);
+    FreeNode(proxy);
+}
+
+void Bvh::Update(uint32_t proxy, const Aabb& bounds, bool refit) {
+    m_Nodes[proxy].Bounds = bounds;
+    if (refit)
+        RefitAncestors(m_Nodes[proxy].Parent);
+}
+
+void Bvh::RefitAncestors(uint32_t node) {
+    while (node != Null) {
+        Node& current = m_Nodes[node];
+        Aabb bounds = Aabb::Union(m_Nodes[current.Children[0]].Bounds, m_Nodes[current.Children[1]].Bounds);
+        // the ancestors already contain it
+        if (bounds.Contains(current.Bounds) && current.Bounds.Contains(bounds))
+            break;
+        current.Bounds = bounds;
+        node = current.Parent;
+    }
+}
+
+void Bvh::Refit() {
+    if (m_Root == Null)
+        return;
+
+    // parents come before their children in a pre order, refit it backwards
+    std::vector<uint32_t> order;
+    order.reserve(m_Nodes.size());
+    order.push_back(m_Root);
+    for (size_t i = 0; i < order.size(); i++) {
+        const Node& node = m_Nodes[order[i]];
+        if (!node.IsLeaf()) {
+            order.push_back(node.Children[0]);
+            order.push_back(node.Children[1]);
+        }
+    }
+    for (size_t i = order.size(); i-- > 0;) {
+        Node& node = m_Nodes[order[i]];
+        if (!node.IsLeaf())
+            node.Bounds = Aabb::Union(m_Nodes[node.Children[0]].Bounds, m_Nodes[node.Children[1]].Bounds);
+    }
+}
+
+void Bvh::Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+    visible.clear();
+    if (m_Root == Null)
+        return;
+
+    // planes the node is fully inside of are not tested again for its 
+    // children, once none is left the whole subtree is visible
+    struct Entry {
+        uint32_t Node;
+        uint32_t Planes;
+    };
+    std::vector<Entry> stack;
+    stack.push_back({ m_Root, 0x3F });
+
+    while (!stack.empty()) {
+        Entry entry = stack.back();
+        stack.pop_back();
+        const Node& node = m_Nodes[entry.Node];
+        uint32_t planes = entry.Planes;
+        if (planes == 0) {
+            if (node.IsLeaf()) {
+                visible.push_back(node.UserData);
+            } else {
+                stack.push_back({ node.Children[0], 0 });
+                stack.push_back({ node.Children[1], 0 });
+            }
+            continue;
+        }
+
+        float center[3], extents[3];
+        for (int axis = 0; axis < 3; axis++) {
+            center[axis] = (node.Bounds.Min[axis] + node.Bounds.Max[axis]) * 0.5f;
+            extents[axis] = (node.Bounds.Max[axis] - node.Bounds.Min[axis]) * 0.5f;
+        }
+
+        bool outside = false;
+        for (int p = 0; p < 6 && !outside; p++) {
+            if (!(planes & (1u << p)))
+                continue;
+            const Plane& plane = frustum.Planes[p];
+            float distance = plane.Evaluate(center);
+            float radius = std::fabs(plane.Normal[0]) * extents[0] + std::fabs(plane.Normal[1]) * extents[1] + 
+                std::fabs(plane.Normal[2]) * extents[2];
+            if (distance + radius < 0.0f)
+                outside = true;
+            else if (distance - radius >= 0.0f)
+                planes &= ~(1u << p);
+        }
+        if (outside)
+            continue;
+
+        if (node.IsLeaf()) {
+            visible.push_back(node.UserData);
+        } else {
+            stack.push_back({ node.Children[0], planes });
+            stack.push_back({ node.Children[1], planes });
+        }
+    }
+}
+
+/**
+ * @brief slab test, the entry t or INFINITY on a miss
+ */
+static float IntersectRay(const Aabb& bounds, const float origin[3], const float inverse[3], float maxDistance) {
+    float tMin = 0.0f, tMax = maxDistance;
+    for (int axis = 0; axis < 3; axis++) {
+        float t0 = (bounds.Min[axis] - origin[axis]) * inverse[axis];
+        float t1 = (bounds.Max[axis] - origin[axis]) * inverse[axis];
+        // 0 * inf is NaN when the ray lies in a slab plane, fmin/fmax ignore it
+        tMin = std::fmax(tMin, std::fmin(t0, t1));
+        tMax = std::fmin(tMax, std::fmax(t0, t1));
+    }
+    return tMin <= tMax ? tMin : INFINITY;
+}
+
+uint32_t Bvh::Raycast(const float origin[3], const float direction[3], float maxDistance, 
+    float* distance) const {
+
+    if (m_Root == Null)
+        return Null;
+
+    float inverse[3];
+    for (int axis = 0; axis < 3; axis++)
+        inverse[axis] = 1.0f / direction[axis];
+
+    uint32_t best = Null;
+    float bestT = maxDistance;
+    std::vector<uint32_t> stack;
+    if (IntersectRay(m_Nodes[m_Root].Bounds, origin, inverse, bestT) != INFINITY)
+        stack.push_back(m_Root);
+
+    while (!stack.empty()) {
+        const Node& node = m_Nodes[stack.back()];
+        stack.pop_back();
+        if (node.IsLeaf()) {
+            float t = IntersectRay(node.Bounds, origin, inverse, bestT);
+            if (t <= bestT) {
+                bestT = t;
+                best = node.UserData;
+            }
+            continue;
+        }
+
+        // the nearer child is visited first, it shrinks bestT for the other
+        float t0 = IntersectRay(m_Nodes[node.Children[0]].Bounds, origin, inverse, bestT);
+        float t1 = IntersectRay(m_Nodes[node.Children[1]].Bounds, origin, inverse, bestT);
+        uint32_t nearChild = node.Children[0], farChild = node.Children[1];
+        if (t1 < t0) {
+            std::swap(t0, t1);
+            std::swap(nearChild, farChild);
+        }
+        if (t1 != INFINITY)
+            stack.push_back(farChild);
+        if (t0 != INFINITY)
+            stack.push_back(nearChild);
+    }
+
+    if (distance && best != Null)
+        *distance = bestT;
+    return best;
+}
+
+uint32_t Bvh::GetHeight() const {
+    if (m_Root == Null)
+        return 0;
+    uint32_t height = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> stack = { { m_Root, 1 } };
+    while (!stack.empty()) {
+        std::pair<uint32_t, uint32_t> entry = stack.back();
+        stack.pop_back();
+        height = std::max(height, entry.second);
+        const Node& node = m_Nodes[entry.first];
+        if (!node.IsLeaf()) {
+            stack.push_back({ node.Children[0], entry.second + 1 });
+            stack.push_back({ node.Children[1], entry.second + 1 });
+        }
+    }
+    return height;
+}
+
+float Bvh::GetCost() const {
+    if (m_Root == Null)
+        return 0.0f;
+    float area = 0.0f;
+    std::vector<uint32_t> stack = { m_Root };
+    while (!stack.empty()) {
+        const Node& node = m_Nodes[stack.back()];
+        stack.pop_back();
+        if (!node.IsLeaf()) {
+            area += node.Bounds.SurfaceArea();
+            stack.push_back(node.Children[0]);
+            stack.push_back(node.Children[1]);
+        }
+    }
+    float rootArea = m_Nodes[m_Root].Bounds.SurfaceArea();
+    return rootArea > 0.0f ? area / rootArea : 0.0f;
+}
@@ -0,0 +1,150 @@
+#include "CommandList.h"
+
+
+CommandList::CommandList(size_t reserve)
+    : m_Storage((reserve + sizeof(uint64_t) - 1) / sizeof(uint64_t)), m_Used(0), m_CommandCount(0) {
+
+    Reset();
+}
+
+void CommandList::Reset() {
+    m_Used = 0;
+    m_CommandCount = 0;
+    m_Packets.clear();
+    m_Packets.push_back({ 0, 0 });
+}
+
+// no GLCall in here, a glGetError per command would cost more than the
+// command: CommandLists::Execute() checks once per replay
+void CommandList::Execute(size_t begin, size_t end, ReplayState& state) const {
+    const uint64_t* words = m_Storage.data();
+    size_t position = begin;
+    while (position < end) {
+        const void* command = words + position;
+        state.Commands++;
+        switch (*(const CommandType*)command) {
+        case USE_PROGRAM: {
+            const UseProgramCommand& use = *(const UseProgramCommand*)command;
+            if (use.Program != state.Program) {
+                glUseProgram(use.Program);
+                state.Program = use.Program;
+            }
+            else
+                state.SkippedBinds++;
+            position += sizeof(UseProgramCommand) / sizeof(uint64_t);
+            break;
+        }
+        case BIND_VERTEX_ARRAY: {
+            const BindVertexArrayCommand& bind = *(const BindVertexArrayCommand*)command;
+            if (bind.VAO != state.VAO) {
+                glBindVertexArray(bind.VAO);
+                state.VAO = bind.VAO;
+            }
+            else
+                state.SkippedBinds++;
+            position += sizeof(BindVertexArrayCommand) / sizeof(uint64_t);
+            break;
+        }
+        case BIND_TEXTURE: {
+            const BindTextureCommand& bind = *(const BindTextureCommand*)command;
+            glActiveTexture(GL_TEXTURE0 + bind.Unit);
+            glBindTexture(bind.Target, bind.Texture);
+            position += sizeof(BindTextureCommand) / sizeof(uint64_t);
+            break;
+        }
+        case UNIFORM_1I: {
+            const Uniform1iCommand& uniform = *(const Uniform1iCommand*)command;
+            glUniform1i(uniform.Location, uniform.Value);
+            position += sizeof(Uniform1iCommand) / sizeof(uint64_t);
+            break;
+        }
+        case UNIFORM_4F: {
+            const Uniform4fCommand& uniform = *(const Uniform4fCommand*)command;
+            glUniform4fv(uniform.Location, 1, uniform.Value);
+            position += sizeof(Uniform4fCommand) / sizeof(uint64_t);
+            break;
+        }
+        case UNIFORM_MATRIX_4: {
+            const UniformMatrix4Command& uniform = *(const UniformMatrix4Command*)command;
+            glUniformMatrix4fv(uniform.Location, 1, GL_FALSE, uniform.Matrix);
+            position += sizeof(UniformMatrix4Command) / sizeof(uint64_t);
+            break;
+        }
+        case DRAW_ARRAYS: {
+            const DrawArraysCommand& draw = *(const DrawArraysCommand*)command;
+            if (draw.Instances == 1)
+                glDrawArrays(draw.Mode, draw.First, draw.Count);
+            else
+                glDrawArraysInstanced(draw.Mode, draw.First, draw.Count, draw.Instances);
+            state.Draws++;
+            position += sizeof(DrawArraysCommand) / sizeof(uint64_t);
+            break;
+        }
+        case DRAW_ELEMENTS: {
+            const DrawElementsCommand& draw = *(const DrawElementsCommand*)command;
+            const void* offset = (const void*)(uintptr_t)draw.Offset;
+            if (draw.Instances == 1)
+                glDrawElementsBaseVertex(draw.Mode, draw.Count, draw.IndexType, offset, draw.BaseVertex);
+            else
+                glDrawElementsInstancedBaseVertex(draw.Mode, draw.Count, draw.IndexType, offset,
+                    draw.Instances, draw.BaseVertex);
+            state.Draws++;
+            position += sizeof(DrawElementsCommand) / sizeof(uint64_t);
+            break;
+        }
+        default:
+            ASSERT(false);
+        }
+    }
+}
+
+
+CommandLists::CommandLists(JobSystem& jobs) : m_Jobs(jobs) {
+    for (unsigned int i = 0; i < jobs.GetThreadCount(); i++)
+        m_Lists.emplace_back(new CommandList());
+}
+
+void CommandLists::Reset() {
+    for (std::unique_ptr<CommandList>& list : m_Lists)
+        list->Reset();
+}
+
+CommandList& CommandLists::GetLocal() {
+    int slot = m_Jobs.GetSlot();
+    ASSERT(slot >= 0);
+    return *m_Lists[slot];
+}
+
+ReplayState CommandLists::Execute(bool sort) {
+    ReplayState state;
+    GLClearError();
+    if (!sort) {
+        for (std::unique_ptr<CommandList>& list : m_Lists)
+            list->Execute(state);
+        ASSERT(GLLogCall("CommandLists::Execute", __FILE__, __LINE__));
+        return state;
+    }
+
+    // every non empty packet of every list, ordered by key (stable: equal
+    // keys keep the list order)
+    m_Queue.Clear();
+    m_Spans.clear();
+    for (uint32_t l = 0; l < (uint32_t)m_Lists.size(); l++) {
+        const std::vector<CommandList::PacketStart>& packets = m_Lists[l]->GetPackets();
+        for (size_t p = 0; p < packets.size(); p++) {
+            uint32_t end = p + 1 < packets.size() ? packets[p + 1].Begin : (uint32_t)m_Lists[l]->GetSize();
+            if (end == packets[p].Begin)
+                continue;
+            m_Queue.Push(packets[p].Key, (uint32_t)m_Spans.size());
+            m_Spans.push_back({ l, packets[p].Begin, end });
+        }
+    }
+    m_Queue.Sort();
+
+    for (const RenderQueue::Item& item : m_Queue.GetItems()) {
+        const Span& span = m_Spans[item.Payload];
+        m_Lists[span.List]->Execute(span.Begin, span.End, state);
+    }
+    ASSERT(GLLogCall("CommandLists::Execute", __FILE__, __LINE__));
+    return state;
+}
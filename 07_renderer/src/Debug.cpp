@@ -0,0 +1,17 @@
+#include "Debug.h"
+
+#include <iostream>
+
+
+void GLClearError(){
+    while(glGetError() != GL_NO_ERROR);
+}
+
+bool GLLogCall(const char* function, const char* file, int line){
+    while(GLenum error = glGetError()){
+        std::cout << "[OpenGl Error] (" << error << "): " << function << 
+        " " << file << ":" << line << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,96 @@
+#include "DrawCommandBuilder.h"
+
+#include <cstring>
+
+#include "IndexData.h"
+
+
+static const GLenum INDEX_TYPES[3] = { GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT };
+
+DrawCommandBuilder::DrawCommandBuilder(uint32_t maxCommands)
+    : m_Indirect(GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect) {
+
+    // the client array fallback has no use for a GL buffer
+    if (m_Indirect)
+        m_Stream.reset(new StreamBuffer((GLsizeiptr)maxCommands * sizeof(DrawElementsIndirectCommand)));
+}
+
+int DrawCommandBuilder::TypeIndex(GLenum type) {
+    switch (type) {
+        case GL_UNSIGNED_BYTE:  return 0;
+        case GL_UNSIGNED_SHORT: return 1;
+        case GL_UNSIGNED_INT:   return 2;
+    }
+    ASSERT(false);
+    return 2;
+}
+
+void DrawCommandBuilder::Reset() {
+    for (std::vector<DrawElementsIndirectCommand>& commands : m_Commands)
+        commands.clear();
+}
+
+void DrawCommandBuilder::Add(GLsizei count, GLenum indexType, GLintptr indexOffset, GLint baseVertex, 
+    GLuint instanceCount, GLuint baseInstance) {
+
+    GLsizei indexSize = GetIndexSize(indexType);
+    ASSERT(indexOffset % indexSize == 0);
+    m_Commands[TypeIndex(indexType)].push_back({(GLuint)count, instanceCount, 
+        (GLuint)(indexOffset / indexSize), baseVertex, baseInstance});
+}
+
+uint32_t DrawCommandBuilder::GetCommandCount() const {
+    return (uint32_t)(m_Commands[0].size() + m_Commands[1].size() + m_Commands[2].size());
+}
+
+uint32_t DrawCommandBuilder::Submit(GLenum mode) {
+    uint32_t calls = 0;
+
+    for (int t = 0; t < 3; t++) {
+        const std::vector<DrawElementsIndirectCommand>& commands = m_Commands[t];
+        if (commands.empty())
+            continue;
+        GLenum type = INDEX_TYPES[t];
+        GLsizei indexSize = GetIndexSize(type);
+
+        if (m_Indirect) {
+            GLsizeiptr size = (GLsizeiptr)(commands.size() * sizeof(DrawElementsIndirectCommand));
+            StreamBuffer::Allocation allocation = m_Stream->Allocate(size, sizeof(DrawElementsIndirectCommand));
+            memcpy(allocation.Data, commands.data(), size);
+            m_Stream->Commit(allocation);
+
+            GLCall( glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_Stream->GetID()) );
+            GLCall( glMultiDrawElementsIndirect(mode, type, (const GLvoid*)allocation.Offset, 
+                (GLsizei)commands.size(), 0) );
+            GLCall( glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0) );
+            calls++;
+            continue;
+        }
+
+        // GL 4.1: same draws from client arrays, instanced ones on their own
+        std::vector<GLsizei> counts;
+        std::vector<const GLvoid*> offsets;
+        std::vector<GLint> baseVertices;
+        for (const DrawElementsIndirectCommand& command : commands) {
+            const GLvoid* offset = (const GLvoid*)((GLintptr)command.FirstIndex * indexSize);
+            if (command.InstanceCount != 1) {
+                GLCall( glDrawElementsInstancedBaseVertex(mode, (GLsizei)command.Count, type, offset, 
+                    (GLsizei)command.InstanceCount, command.BaseVertex) );
+                calls++;
+                continue;
+            }
+            counts.push_back((GLsizei)command.Count);
+            offsets.push_back(offset);
+            baseVertices.push_back(command.BaseVertex);
+        }
+        if (!counts.empty()) {
+            GLCall( glMultiDrawElementsBaseVertex(mode, counts.data(), type, 
+                (const GLvoid* const*)offsets.data(), (GLsizei)counts.size(), baseVertices.data()) );
+            calls++;
+        }
+    }
+
+    if (m_Indirect)
+        m_Stream->EndFrame();
+    return calls;
+}
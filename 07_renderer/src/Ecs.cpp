@@ -0,0 +1,152 @@
+#include "Ecs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+
+
+// written once by Register(), before the id is handed out
+static ComponentRegistry::Info s_Components[ECS_MAX_COMPONENTS];
+static std::atomic<uint32_t> s_ComponentCount(0);
+
+static const size_t CACHE_LINE = 64;
+
+uint32_t ComponentRegistry::Register(size_t size, size_t alignment) {
+    uint32_t id = s_ComponentCount++;
+    ASSERT(id < ECS_MAX_COMPONENTS && alignment <= CACHE_LINE);
+    s_Components[id] = { (uint32_t)size, (uint32_t)alignment };
+    return id;
+}
+
+const ComponentRegistry::Info& ComponentRegistry::GetInfo(uint32_t id) {
+    return s_Components[id];
+}
+
+
+Archetype::Archetype(ComponentMask mask) : m_Mask(mask), m_Offsets() {
+    size_t rowSize = sizeof(Entity);
+    for (uint32_t id = 0; id < ECS_MAX_COMPONENTS; id++) {
+        if (mask & (ComponentMask(1) << id)) {
+            m_Components.push_back(id);
+            rowSize += ComponentRegistry::GetInfo(id).Size;
+        }
+    }
+
+    // every array starts on a cache line, keep room for the padding
+    size_t padding = CACHE_LINE * (m_Components.size() + 1);
+    m_Capacity = (uint32_t)std::max<size_t>(1, (ECS_CHUNK_SIZE - padding) / rowSize);
+    size_t offset = (sizeof(Entity) * m_Capacity + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+    for (uint32_t id : m_Components) {
+        m_Offsets[id] = (uint32_t)offset;
+        offset += ComponentRegistry::GetInfo(id).Size * m_Capacity;
+        offset = (offset + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+    }
+    // more than ECS_CHUNK_SIZE only when a single row doesn't fit
+    m_ChunkSize = std::max(ECS_CHUNK_SIZE, offset);
+}
+
+Archetype::~Archetype() {
+    for (Chunk& chunk : m_Chunks)
+        ::operator delete(chunk.Data, std::align_val_t(CACHE_LINE));
+}
+
+void Archetype::AddRow(Entity entity, uint32_t& chunk, uint32_t& row) {
+    if (m_Chunks.empty() || m_Chunks.back().Count == m_Capacity)
+        m_Chunks.push_back({ (uint8_t*)::operator new(m_ChunkSize, std::align_val_t(CACHE_LINE)), 0 });
+    chunk = (uint32_t)m_Chunks.size() - 1;
+    row = m_Chunks.back().Count++;
+    GetEntities(m_Chunks.back())[row] = entity;
+}
+
+Entity Archetype::RemoveRow(uint32_t chunk, uint32_t row) {
+    Chunk& last = m_Chunks.back();
+    uint32_t lastRow = last.Count - 1;
+    Entity moved = GetEntities(last)[lastRow];
+    if (&last != &m_Chunks[chunk] || row != lastRow) {
+        GetEntities(m_Chunks[chunk])[row] = moved;
+        for (uint32_t id : m_Components) {
+            uint32_t size = ComponentRegistry::GetInfo(id).Size;
+            memcpy(m_Chunks[chunk].Data + m_Offsets[id] + (size_t)row * size,
+                last.Data + m_Offsets[id] + (size_t)lastRow * size, size);
+        }
+    }
+    // empty chunks are released, the others stay full but the last
+    if (--last.Count == 0) {
+        ::operator delete(last.Data, std::align_val_t(CACHE_LINE));
+        m_Chunks.pop_back();
+    }
+    return moved;
+}
+
+
+uint32_t World::GetArchetype(ComponentMask mask) {
+    auto found = m_ArchetypeIndex.find(mask);
+    if (found != m_ArchetypeIndex.end())
+        return found->second;
+    uint32_t index = (uint32_t)m_Archetypes.size();
+    m_Archetypes.emplace_back(new Archetype(mask));
+    m_ArchetypeIndex[mask] = index;
+    return index;
+}
+
+Entity World::CreateEntity(ComponentMask mask, Location& location) {
+    Entity entity;
+    if (!m_FreeIndices.empty()) {
+        entity.Index = m_FreeIndices.back();
+        m_FreeIndices.pop_back();
+        entity.Generation = m_Locations[entity.Index].Generation;
+    }
+    else {
+        entity.Index = (uint32_t)m_Locations.size();
+        entity.Generation = 0;
+        m_Locations.push_back({ Dead, 0, 0, 0 });
+    }
+
+    location.Archetype = GetArchetype(mask);
+    location.Generation = entity.Generation;
+    m_Archetypes[location.Archetype]->AddRow(entity, location.Chunk, location.Row);
+    m_Locations[entity.Index] = location;
+    m_EntityCount++;
+    return entity;
+}
+
+void World::Relocate(uint32_t archetype, uint32_t chunk, uint32_t row) {
+    const std::vector<Archetype::Chunk>& chunks = m_Archetypes[archetype]->GetChunks();
+    if (chunk >= chunks.size() || row >= chunks[chunk].Count)
+        return;     // the removed row was the last one
+    Entity moved = m_Archetypes[archetype]->GetEntities(chunks[chunk])[row];
+    m_Locations[moved.Index].Chunk = chunk;
+    m_Locations[moved.Index].Row = row;
+}
+
+void World::Destroy(Entity entity) {
+    ASSERT(IsAlive(entity));
+    Location& location = m_Locations[entity.Index];
+    m_Archetypes[location.Archetype]->RemoveRow(location.Chunk, location.Row);
+    Relocate(location.Archetype, location.Chunk, location.Row);
+
+    location.Archetype = Dead;
+    location.Generation++;
+    m_FreeIndices.push_back(entity.Index);
+    m_EntityCount--;
+}
+
+void World::Move(Entity entity, ComponentMask mask) {
+    Location from = m_Locations[entity.Index];
+    Location to = from;
+    to.Archetype = GetArchetype(mask);
+    Archetype& source = *m_Archetypes[from.Archetype];
+    Archetype& destination = *m_Archetypes[to.Archetype];
+    destination.AddRow(entity, to.Chunk, to.Row);
+
+    for (uint32_t id : source.GetComponents()) {
+        if (mask & (ComponentMask(1) << id)) {
+            memcpy(destination.GetComponent(id, to.Chunk, to.Row), source.GetComponent(id, from.Chunk, from.Row),
+                ComponentRegistry::GetInfo(id).Size);
+        }
+    }
+    source.RemoveRow(from.Chunk, from.Row);
+    Relocate(from.Archetype, from.Chunk, from.Row);
+    m_Locations[entity.Index] = to;
+}
@@ -0,0 +1,278 @@
+#include "FrustumCuller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Parallel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CULL_X86
+#include <immintrin.h>
+#endif
+
+
+// objects culled by one task
+static const size_t CULL_BLOCK = 16384;
+
+struct CullInput {
+    const float* CenterX;
+    const float* CenterY;
+    const float* CenterZ;
+    const float* ExtentX;
+    const float* ExtentY;
+    const float* ExtentZ;
+    const float* Radius;
+};
+
+/**
+ * @brief the planes as SoA too, with the absolute normals the box test 
+ * projects the extents on
+ */
+struct CullPlanes {
+    float NX[6], NY[6], NZ[6], D[6];
+    float AX[6], AY[6], AZ[6];
+};
+
+typedef size_t (*CullKernel)(const CullInput&, const CullPlanes&, size_t, size_t, uint32_t*);
+
+/**
+ * @brief the reference, and what the SIMD kernels run on their tail
+ */
+template<bool Box>
+static size_t CullScalar(const CullInput& in, const CullPlanes& planes, size_t begin, size_t end, 
+    uint32_t* out) {
+
+    size_t count = 0;
+    for (size_t i = begin; i < end; i++) {
+        bool outside = false;
+        for (int p = 0; p < 6; p++) {
+            float distance = planes.NX[p] * in.CenterX[i] + planes.NY[p] * in.CenterY[i] + 
+                planes.NZ[p] * in.CenterZ[i] + planes.D[p];
+            float radius = Box ? planes.AX[p] * in.ExtentX[i] + planes.AY[p] * in.ExtentY[i] + 
+                planes.AZ[p] * in.ExtentZ[i] : in.Radius[i];
+            outside |= distance + radius < 0.0f;
+        }
+        out[count] = (uint32_t)i;
+        count += !outside;
+    }
+    return count;
+}
+
+#ifdef CULL_X86
+
+template<bool Box>
+static size_t CullSSE(const CullInput& in, const CullPlanes& planes, size_t begin, size_t end, 
+    uint32_t* out) {
+
+    size_t count = 0, i = begin;
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= end; i += 4) {
+        __m128 cx = _mm_loadu_ps(in.CenterX + i), cy = _mm_loadu_ps(in.CenterY + i), cz = _mm_loadu_ps(in.CenterZ + i);
+        __m128 ex, ey, ez, r;
+        if (Box) {
+            ex = _mm_loadu_ps(in.ExtentX + i);
+            ey = _mm_loadu_ps(in.ExtentY + i);
+            ez = _mm_loadu_ps(in.ExtentZ + i);
+        } else {
+            r = _mm_loadu_ps(in.Radius + i);
+        }
+
+        __m128 outside = zero;
+        for (int p = 0; p < 6; p++) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.NX[p]), cx), 
+                _mm_mul_ps(_mm_set1_ps(planes.NY[p]), cy)), 
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.NZ[p]), cz), _mm_set1_ps(planes.D[p])));
+            if (Box) {
+                r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.AX[p]), ex), 
+                    _mm_mul_ps(_mm_set1_ps(planes.AY[p]), ey)), _mm_mul_ps(_mm_set1_ps(planes.AZ[p]), ez));
+            }
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, r), zero));
+        }
+
+        unsigned int visible = ~_mm_movemask_ps(outside) & 0xF;
+        while (visible) {
+            out[count++] = (uint32_t)(i + __builtin_ctz(visible));
+            visible &= visible - 1;
+        }
+    }
+    return count + CullScalar<Box>(in, planes, i, end, out + count);
+}
+
+template<bool Box>
+__attribute__((target("avx2,fma")))
+static size_t CullAVX2(const CullInput& in, const CullPlanes& planes, size_t begin, size_t end, 
+    uint32_t* out) {
+
+    size_t count = 0, i = begin;
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= end; i += 8) {
+        __m256 cx = _mm256_loadu_ps(in.CenterX + i), cy = _mm256_loadu_ps(in.CenterY + i);
+        __m256 cz = _mm256_loadu_ps(in.CenterZ + i);
+        __m256 ex, ey, ez, r;
+        if (Box) {
+            ex = _mm256_loadu_ps(in.ExtentX + i);
+            ey = _mm256_loadu_ps(in.ExtentY + i);
+            ez = _mm256_loadu_ps(in.ExtentZ + i);
+        } else {
+            r = _mm256_loadu_ps(in.Radius + i);
+        }
+
+        __m256 outside = zero;
+        for (int p = 0; p < 6; p++) {
+            __m256 distance = _mm256_fmadd_ps(_mm256_set1_ps(planes.NX[p]), cx, 
+                _mm256_fmadd_ps(_mm256_set1_ps(planes.NY[p]), cy, 
+                _mm256_fmadd_ps(_mm256_set1_ps(planes.NZ[p]), cz, _mm256_set1_ps(planes.D[p]))));
+            if (Box) {
+                r = _mm256_fmadd_ps(_mm256_set1_ps(planes.AX[p]), ex, 
+                    _mm256_fmadd_ps(_mm256_set1_ps(planes.AY[p]), ey, _mm256_mul_ps(_mm256_set1_ps(planes.AZ[p]), ez)));
+            }
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, r), zero, _CMP_LT_OQ));
+        }
+
+        unsigned int visible = ~_mm256_movemask_ps(outside) & 0xFF;
+        while (visible) {
+            out[count++] = (uint32_t)(i + __builtin_ctz(visible));
+            visible &= visible - 1;
+        }
+    }
+    return count + CullScalar<Box>(in, planes, i, end, out + count);
+}
+
+template<bool Box>
+__attribute__((target("avx512f")))
+static size_t CullAVX512(const CullInput& in, const CullPlanes& planes, size_t begin, size_t end, 
+    uint32_t* out) {
+
+    size_t count = 0, i = begin;
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    for (; i + 16 <= end; i += 16) {
+        __m512 cx = _mm512_loadu_ps(in.CenterX + i), cy = _mm512_loadu_ps(in.CenterY + i);
+        __m512 cz = _mm512_loadu_ps(in.CenterZ + i);
+        __m512 ex, ey, ez, r;
+        if (Box) {
+            ex = _mm512_loadu_ps(in.ExtentX + i);
+            ey = _mm512_loadu_ps(in.ExtentY + i);
+            ez = _mm512_loadu_ps(in.ExtentZ + i);
+        } else {
+            r = _mm512_loadu_ps(in.Radius + i);
+        }
+
+        __mmask16 outside = 0;
+        for (int p = 0; p < 6; p++) {
+            __m512 distance = _mm512_fmadd_ps(_mm512_set1_ps(planes.NX[p]), cx, 
+                _mm512_fmadd_ps(_mm512_set1_ps(planes.NY[p]), cy, 
+                _mm512_fmadd_ps(_mm512_set1_ps(planes.NZ[p]), cz, _mm512_set1_ps(planes.D[p]))));
+            if (Box) {
+                r = _mm512_fmadd_ps(_mm512_set1_ps(planes.AX[p]), ex, 
+                    _mm512_fmadd_ps(_mm512_set1_ps(planes.AY[p]), ey, _mm512_mul_ps(_mm512_set1_ps(planes.AZ[p]), ez)));
+            }
+            outside |= _mm512_cmp_ps_mask(_mm512_add_ps(distance, r), zero, _CMP_LT_OQ);
+        }
+
+        // the visible indices are packed by the store itself
+        __mmask16 visible = (__mmask16)~outside;
+        __m512i indices = _mm512_add_epi32(_mm512_set1_epi32((int)i), lanes);
+        _mm512_mask_compressstoreu_epi32(out + count, visible, indices);
+        count += __builtin_popcount(visible);
+    }
+    return count + CullScalar<Box>(in, planes, i, end, out + count);
+}
+
+#endif
+
+static CullKernel SelectKernel(bool box) {
+#ifdef CULL_X86
+    static const int level = __builtin_cpu_supports("avx512f") ? 3 : 
+        (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ? 2 : 1;
+    switch (level) {
+        case 3: return box ? CullAVX512<true> : CullAVX512<false>;
+        case 2: return box ? CullAVX2<true> : CullAVX2<false>;
+        default: return box ? CullSSE<true> : CullSSE<false>;
+    }
+#else
+    return box ? CullScalar<true> : CullScalar<false>;
+#endif
+}
+
+const char* FrustumCuller::GetInstructionSet() {
+#ifdef CULL_X86
+    if (__builtin_cpu_supports("avx512f"))
+        return "avx512";
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return "avx2";
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
+
+void FrustumCuller::Reserve(size_t count) {
+    for (std::vector<float>* array : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, 
+        &m_ExtentZ, &m_Radius })
+        array->reserve(count);
+}
+
+void FrustumCuller::Clear() {
+    for (std::vector<float>* array : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, 
+        &m_ExtentZ, &m_Radius })
+        array->clear();
+}
+
+uint32_t FrustumCuller::Add(const float center[3], const float extents[3]) {
+    uint32_t index = (uint32_t)m_CenterX.size();
+    for (std::vector<float>* array : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, 
+        &m_ExtentZ, &m_Radius })
+        array->push_back(0.0f);
+    Update(index, center, extents);
+    return index;
+}
+
+void FrustumCuller::Update(uint32_t index, const float center[3], const float extents[3]) {
+    m_CenterX[index] = center[0];
+    m_CenterY[index] = center[1];
+    m_CenterZ[index] = center[2];
+    m_ExtentX[index] = extents[0];
+    m_ExtentY[index] = extents[1];
+    m_ExtentZ[index] = extents[2];
+    m_Radius[index] = std::sqrt(extents[0] * extents[0] + extents[1] * extents[1] + extents[2] * extents[2]);
+}
+
+size_t FrustumCuller::Cull(const Frustum& frustum, std::vector<uint32_t>& visible, Volume volume, 
+    unsigned int maxThreads) const {
+
+    CullPlanes planes;
+    for (int p = 0; p < 6; p++) {
+        const Plane& plane = frustum.Planes[p];
+        planes.NX[p] = plane.Normal[0];
+        planes.NY[p] = plane.Normal[1];
+        planes.NZ[p] = plane.Normal[2];
+        planes.D[p] = plane.Distance;
+        planes.AX[p] = std::fabs(plane.Normal[0]);
+        planes.AY[p] = std::fabs(plane.Normal[1]);
+        planes.AZ[p] = std::fabs(plane.Normal[2]);
+    }
+    CullInput in = { m_CenterX.data(), m_CenterY.data(), m_CenterZ.data(), m_ExtentX.data(), 
+        m_ExtentY.data(), m_ExtentZ.data(), m_Radius.data() };
+    CullKernel kernel = SelectKernel(volume == Volume::Box);
+
+    // every block fills its own slice, then the slices are packed
+    size_t count = GetCount();
+    size_t blocks = (count + CULL_BLOCK - 1) / CULL_BLOCK;
+    visible.resize(count);
+    std::vector<size_t> counts(blocks);
+    ParallelFor(blocks, [&](size_t block) {
+        size_t begin = block * CULL_BLOCK, end = std::min(begin + CULL_BLOCK, count);
+        counts[block] = kernel(in, planes, begin, end, &visible[begin]);
+    }, maxThreads);
+
+    size_t total = 0;
+    for (size_t block = 0; block < blocks; block++) {
+        if (total != block * CULL_BLOCK)
+            memmove(&visible[total], &visible[block * CULL_BLOCK], counts[block] * sizeof(uint32_t));
+        total += counts[block];
+    }
+    visible.resize(total);
+    return total;
+}
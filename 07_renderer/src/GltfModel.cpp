@@ -0,0 +1,232 @@
+#include "GltfModel.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "Json.h"
+
+
+static const uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+static const uint32_t CHUNK_JSON = 0x4E4F534A;     // "JSON"
+static const uint32_t CHUNK_BIN = 0x004E4942;      // "BIN\0"
+
+static uint32_t ReadU32(const char* p) {
+    uint32_t value;
+    memcpy(&value, p, 4);
+    return value;
+}
+
+static GLint ComponentCount(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    return 0; // matrices are not vertex attributes
+}
+
+static GLsizei ComponentSize(GLenum componentType) {
+    switch (componentType) {
+        case GL_BYTE: case GL_UNSIGNED_BYTE: return 1;
+        case GL_SHORT: case GL_UNSIGNED_SHORT: return 2;
+        case GL_UNSIGNED_INT: case GL_FLOAT: return 4;
+    }
+    return 0;
+}
+
+// what glDrawElements takes
+static bool IsIndexType(GLenum componentType) {
+    return componentType == GL_UNSIGNED_BYTE || componentType == GL_UNSIGNED_SHORT || 
+        componentType == GL_UNSIGNED_INT;
+}
+
+static bool SemanticLocation(const std::string& semantic, GLuint& location) {
+    if (semantic == "POSITION")   { location = GLTF_POSITION; return true; }
+    if (semantic == "NORMAL")     { location = GLTF_NORMAL; return true; }
+    if (semantic == "TEXCOORD_0") { location = GLTF_TEXCOORD_0; return true; }
+    if (semantic == "COLOR_0")    { location = GLTF_COLOR_0; return true; }
+    if (semantic == "TANGENT")    { location = GLTF_TANGENT; return true; }
+    return false;
+}
+
+/**
+ * @brief byte offset of an accessor inside the BIN chunk and its stride
+ */
+static bool ResolveAccessor(const JsonValue& gltf, const JsonValue& accessor, size_t binSize, 
+    GLintptr& offset, GLsizei& stride, GLenum& componentType, GLint& components) {
+
+    if (!accessor.Has("bufferView") || accessor.Has("sparse"))
+        return false;
+    const JsonValue& view = gltf["bufferViews"][(size_t)accessor["bufferView"].AsNumber()];
+    if ((size_t)view["buffer"].AsNumber() != 0)
+        return false; // only the GLB embedded buffer
+
+    componentType = (GLenum)accessor["componentType"].AsNumber();
+    components = ComponentCount(accessor["type"].AsString());
+    GLsizei elementSize = ComponentSize(componentType) * components;
+    if (elementSize == 0)
+        return false;
+
+    offset = (GLintptr)view["byteOffset"].AsNumber() + (GLintptr)accessor["byteOffset"].AsNumber();
+    stride = (GLsizei)view["byteStride"].AsNumber(0.0);
+    size_t count = (size_t)accessor["count"].AsNumber();
+    size_t last = count ? (size_t)offset + (count - 1) * (stride ? stride : elementSize) + elementSize : 0;
+    return last <= binSize;
+}
+
+bool GltfModel::LoadGlb(const std::string& filePath) {
+    Release();
+
+    MappedFile file;
+    if (!file.Open(filePath))
+        return false;
+    const char* data = file.GetData();
+    size_t size = file.GetSize();
+
+    // 12 bytes header, then chunks: length, type, data (4 bytes aligned)
+    if (size < 20 || ReadU32(data) != GLB_MAGIC || ReadU32(data + 4) != 2) {
+        std::cout << filePath << " is not a glTF 2.0 binary" << std::endl;
+        return false;
+    }
+
+    const char* json = nullptr;
+    const char* bin = nullptr;
+    size_t jsonSize = 0, binSize = 0;
+    for (size_t p = 12; p + 8 <= size;) {
+        size_t length = ReadU32(data + p);
+        uint32_t type = ReadU32(data + p + 4);
+        if (p + 8 + length > size)
+            break;
+        if (type == CHUNK_JSON && !json) {
+            json = data + p + 8;
+            jsonSize = length;
+        } else if (type == CHUNK_BIN && !bin) {
+            bin = data + p + 8;
+            binSize = length;
+        }
+        p += 8 + ((length + 3) & ~(size_t)3);
+    }
+
+    JsonValue gltf;
+    if (!json || !JsonValue::Parse(json, jsonSize, gltf)) {
+        std::cout << filePath << ": invalid JSON chunk" << std::endl;
+        return false;
+    }
+    if (!bin) {
+        std::cout << filePath << ": no BIN chunk, external buffers are not supported" << std::endl;
+        return false;
+    }
+
+    // the whole BIN chunk in one go, straight from the mapping
+    GLCall( glGenBuffers(1, &m_Buffer) );
+    GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, m_Buffer) );
+    if (GLEW_ARB_buffer_storage) {
+        GLCall( glBufferStorage(GL_COPY_WRITE_BUFFER, binSize, bin, 0) );
+    } else {
+        GLCall( glBufferData(GL_COPY_WRITE_BUFFER, binSize, bin, GL_STATIC_DRAW) );
+    }
+    GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, 0) );
+
+    const JsonValue& meshes = gltf["meshes"];
+    for (size_t m = 0; m < meshes.GetSize(); m++) {
+        const JsonValue& primitives = meshes[m]["primitives"];
+        for (size_t p = 0; p < primitives.GetSize(); p++) {
+            const JsonValue& primitive = primitives[p];
+            const JsonValue& attributes = primitive["attributes"];
+            if (!attributes.Has("POSITION")) {
+                std::cout << filePath << ": primitive without POSITION skipped" << std::endl;
+                continue;
+            }
+
+            Primitive draw;
+            draw.Mode = (GLenum)primitive["mode"].AsNumber(GL_TRIANGLES);
+            draw.IndexType = 0;
+            draw.IndexOffset = 0;
+            draw.Count = (GLsizei)gltf["accessors"][(size_t)attributes["POSITION"].AsNumber()]["count"].AsNumber();
+
+            GLCall( glGenVertexArrays(1, &draw.VAO) );
+            GLCall( glBindVertexArray(draw.VAO) );
+            GLCall( glBindBuffer(GL_ARRAY_BUFFER, m_Buffer) );
+
+            // a primitive we can't draw as the file says is dropped, not drawn wrong
+            bool valid = true;
+            for (const auto& attribute : attributes.GetMembers()) {
+                GLuint location;
+                if (!SemanticLocation(attribute.first, location))
+                    continue;
+                const JsonValue& accessor = gltf["accessors"][(size_t)attribute.second.AsNumber()];
+
+                GLintptr offset;
+                GLsizei stride;
+                GLenum componentType;
+                GLint components;
+                if (!ResolveAccessor(gltf, accessor, binSize, offset, stride, componentType, components)) {
+                    std::cout << filePath << ": unsupported accessor for " << attribute.first << std::endl;
+                    valid = valid && attribute.first != "POSITION";
+                    continue;
+                }
+
+                // stride 0 is "tightly packed" for GL too
+                GLCall( glEnableVertexAttribArray(location) );
+                GLCall( glVertexAttribPointer(location, components, componentType, 
+                    accessor["normalized"].AsBool() ? GL_TRUE : GL_FALSE, stride, (const GLvoid*)offset) );
+            }
+
+            if (primitive.Has("indices")) {
+                const JsonValue& accessor = gltf["accessors"][(size_t)primitive["indices"].AsNumber()];
+                GLintptr offset;
+                GLsizei stride;
+                GLenum componentType;
+                GLint components;
+                // GL reads the indices tightly packed from an aligned offset
+                if (ResolveAccessor(gltf, accessor, binSize, offset, stride, componentType, components) && 
+                    components == 1 && IsIndexType(componentType) && 
+                    (stride == 0 || stride == ComponentSize(componentType)) && 
+                    offset % ComponentSize(componentType) == 0) {
+                    // the same buffer, this time as index buffer of the VAO
+                    GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Buffer) );
+                    draw.IndexType = componentType;
+                    draw.IndexOffset = offset;
+                    draw.Count = (GLsizei)accessor["count"].AsNumber();
+                } else {
+                    std::cout << filePath << ": unsupported index accessor" << std::endl;
+                    valid = false;
+                }
+            }
+
+            GLCall( glBindVertexArray(0) );
+            GLCall( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+            if (!valid) {
+                std::cout << filePath << ": primitive skipped" << std::endl;
+                GLCall( glDeleteVertexArrays(1, &draw.VAO) );
+                continue;
+            }
+            m_Primitives.push_back(draw);
+        }
+    }
+
+    // the GPU copy is done, the mapping goes away with file
+    return !m_Primitives.empty();
+}
+
+void GltfModel::Release() {
+    for (Primitive& primitive : m_Primitives)
+        glDeleteVertexArrays(1, &primitive.VAO);
+    m_Primitives.clear();
+    if (m_Buffer)
+        glDeleteBuffers(1, &m_Buffer);
+    m_Buffer = 0;
+}
+
+void GltfModel::Draw() const {
+    for (const Primitive& primitive : m_Primitives) {
+        GLCall( glBindVertexArray(primitive.VAO) );
+        if (primitive.IndexType) {
+            GLCall( glDrawElements(primitive.Mode, primitive.Count, primitive.IndexType, 
+                (const GLvoid*)primitive.IndexOffset) );
+        } else {
+            GLCall( glDrawArrays(primitive.Mode, 0, primitive.Count) );
+        }
+    }
+    GLCall( glBindVertexArray(0) );
+}
@@ -0,0 +1,224 @@
+#include "IndexData.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+// an extra draw call is considered as expensive as fetching this many 
+// index bytes, splitting has to save more than that per chunk
+static const size_t CHUNK_DRAW_COST = 4096;
+
+GLsizei GetIndexSize(GLenum type) {
+    switch (type) {
+        case GL_UNSIGNED_BYTE:  return 1;
+        case GL_UNSIGNED_SHORT: return 2;
+        case GL_UNSIGNED_INT:   return 4;
+    }
+    ASSERT(false);
+    return 0;
+}
+
+template<typename T>
+static void Convert(const GLuint* indices, uint32_t count, GLuint base, uint8_t* dst) {
+    T* out = (T*)dst;
+    for (uint32_t i = 0; i < count; i++)
+        out[i] = (T)(indices[i] - base);
+}
+
+/**
+ * @brief greedy split of a triangle list in runs of triangles whose indices 
+ * stay within [min, min + 65535]
+ */
+static std::vector<IndexChunk> SplitTriangles(const GLuint* indices, uint32_t count) {
+    std::vector<IndexChunk> chunks;
+
+    uint32_t first = 0;
+    GLuint lo = 0xFFFFFFFF, hi = 0;
+    for (uint32_t i = 0; i + 2 < count; i += 3) {
+        GLuint triLo = std::min({indices[i], indices[i + 1], indices[i + 2]});
+        GLuint triHi = std::max({indices[i], indices[i + 1], indices[i + 2]});
+        GLuint newLo = std::min(lo, triLo), newHi = std::max(hi, triHi);
+
+        if (newHi - newLo > 0xFFFF && i > first) {
+            chunks.push_back({(GLintptr)first * 2, (GLsizei)(i - first), (GLint)lo});
+            first = i;
+            newLo = triLo;
+            newHi = triHi;
+        }
+        lo = newLo;
+        hi = newHi;
+    }
+    if (first < count)
+        chunks.push_back({(GLintptr)first * 2, (GLsizei)(count - first), (GLint)lo});
+
+    return chunks;
+}
+
+IndexData NarrowIndices(const GLuint* indices, uint32_t count, bool triangles) {
+    IndexData data;
+    data.Count = (GLsizei)count;
+
+    GLuint maxIndex = 0;
+    for (uint32_t i = 0; i < count; i++)
+        maxIndex = std::max(maxIndex, indices[i]);
+
+    if (maxIndex <= 0xFF) {
+        data.Type = GL_UNSIGNED_BYTE;
+        data.Bytes.resize(count);
+        Convert<GLubyte>(indices, count, 0, data.Bytes.data());
+    } else if (maxIndex <= 0xFFFF) {
+        data.Type = GL_UNSIGNED_SHORT;
+        data.Bytes.resize(count * 2);
+        Convert<GLushort>(indices, count, 0, data.Bytes.data());
+    } else {
+        // 16 bit chunks save 2 bytes per index, but cost a draw call each 
+        // (a triangle that alone spans more than 65536 vertices can't fit)
+        std::vector<IndexChunk> chunks;
+        if (triangles && count % 3 == 0)
+            chunks = SplitTriangles(indices, count);
+
+        bool fits = !chunks.empty();
+        for (const IndexChunk& chunk : chunks) {
+            const GLuint* src = indices + chunk.ByteOffset / 2;
+            for (GLsizei i = 0; i < chunk.Count && fits; i++)
+                fits = src[i] - (GLuint)chunk.BaseVertex <= 0xFFFF;
+        }
+
+        size_t saved = (size_t)count * 2;
+        if (fits && saved > (chunks.size() - 1) * CHUNK_DRAW_COST) {
+            data.Type = GL_UNSIGNED_SHORT;
+            data.Bytes.resize(count * 2);
+            for (const IndexChunk& chunk : chunks)
+                Convert<GLushort>(indices + chunk.ByteOffset / 2, chunk.Count, chunk.BaseVertex, 
+                    data.Bytes.data() + chunk.ByteOffset);
+            data.Chunks = chunks;
+        } else {
+            data.Type = GL_UNSIGNED_INT;
+            data.Bytes.resize(count * 4);
+            memcpy(data.Bytes.data(), indices, count * 4);
+        }
+    }
+
+    if (data.Chunks.empty())
+        data.Chunks.push_back({0, (GLsizei)count, 0});
+
+    return data;
+}
+
+GLuint GetRestartIndex(GLenum type) {
+    switch (type) {
+        case GL_UNSIGNED_BYTE:  return 0xFF;
+        case GL_UNSIGNED_SHORT: return 0xFFFF;
+        case GL_UNSIGNED_INT:   return 0xFFFFFFFF;
+    }
+    ASSERT(false);
+    return 0;
+}
+
+/**
+ * @brief directed edge a -> b, a triangle (a, b, c) owns a -> b, b -> c 
+ * and c -> a. Its neighbour across a -> b owns b -> a.
+ */
+static uint64_t EdgeKey(GLuint a, GLuint b) {
+    return ((uint64_t)a << 32) | b;
+}
+
+std::vector<GLuint> StripifyTriangles(const GLuint* indices, uint32_t count) {
+    uint32_t triangleCount = count / 3;
+
+    // (edge, triangle) sorted by edge, to find the triangles owning an edge
+    std::vector<std::pair<uint64_t, uint32_t>> edges;
+    edges.reserve(count);
+    std::vector<bool> used(triangleCount, false);
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        GLuint a = indices[t * 3], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+        if (a == b || b == c || c == a) {
+            used[t] = true;
+            continue;
+        }
+        edges.push_back({EdgeKey(a, b), t});
+        edges.push_back({EdgeKey(b, c), t});
+        edges.push_back({EdgeKey(c, a), t});
+    }
+    std::sort(edges.begin(), edges.end());
+
+    // an unused triangle owning a -> b, and its third vertex
+    auto findNext = [&](GLuint a, GLuint b, GLuint& third) -> int64_t {
+        auto it = std::lower_bound(edges.begin(), edges.end(), std::make_pair(EdgeKey(a, b), 0u));
+        for (; it != edges.end() && it->first == EdgeKey(a, b); ++it) {
+            if (used[it->second])
+                continue;
+            const GLuint* triangle = &indices[it->second * 3];
+            third = triangle[0] + triangle[1] + triangle[2] - a - b;
+            return it->second;
+        }
+        return -1;
+    };
+
+    std::vector<GLuint> strip;
+    strip.reserve(count);
+    for (uint32_t seed = 0; seed < triangleCount; seed++) {
+        if (used[seed])
+            continue;
+        used[seed] = true;
+
+        // start with the rotation that can be continued, if any
+        const GLuint* triangle = &indices[seed * 3];
+        int rotation = 0;
+        for (int r = 0; r < 3; r++) {
+            GLuint third;
+            if (findNext(triangle[(r + 2) % 3], triangle[(r + 1) % 3], third) >= 0) {
+                rotation = r;
+                break;
+            }
+        }
+
+        if (!strip.empty())
+            strip.push_back(PRIMITIVE_RESTART_INDEX);
+        size_t start = strip.size();
+        for (int k = 0; k < 3; k++)
+            strip.push_back(triangle[(rotation + k) % 3]);
+
+        // triangle k of the strip is (k, k + 1, k + 2) when k is even and 
+        // (k + 1, k, k + 2) when odd, its first edge has to be shared
+        for (;;) {
+            size_t k = strip.size() - 2 - start;
+            GLuint p = strip[strip.size() - 2], q = strip[strip.size() - 1];
+            GLuint third;
+            int64_t next = k % 2 == 0 ? findNext(p, q, third) : findNext(q, p, third);
+            if (next < 0)
+                break;
+            used[next] = true;
+            strip.push_back(third);
+        }
+    }
+    return strip;
+}
+
+IndexData NarrowStripIndices(const GLuint* indices, uint32_t count) {
+    IndexData data;
+    data.Count = (GLsizei)count;
+
+    GLuint maxIndex = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (indices[i] != PRIMITIVE_RESTART_INDEX)
+            maxIndex = std::max(maxIndex, indices[i]);
+    }
+
+    // the truncation turns PRIMITIVE_RESTART_INDEX into the restart index of the type
+    if (maxIndex < 0xFF) {
+        data.Type = GL_UNSIGNED_BYTE;
+        data.Bytes.resize(count);
+        Convert<GLubyte>(indices, count, 0, data.Bytes.data());
+    } else if (maxIndex < 0xFFFF) {
+        data.Type = GL_UNSIGNED_SHORT;
+        data.Bytes.resize(count * 2);
+        Convert<GLushort>(indices, count, 0, data.Bytes.data());
+    } else {
+        data.Type = GL_UNSIGNED_INT;
+        data.Bytes.resize(count * 4);
+        memcpy(data.Bytes.data(), indices, count * 4);
+    }
+    data.Chunks.push_back({0, (GLsizei)count, 0});
+    return data;
+}
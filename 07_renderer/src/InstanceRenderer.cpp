@@ -0,0 +1,72 @@
+#include "InstanceRenderer.h"
+
+#include <algorithm>
+#include <cstddef>
+
+
+InstanceRenderer::InstanceRenderer(GLuint vao, GLuint firstLocation, uint32_t maxInstances)
+    : m_VAO(vao), m_FirstLocation(firstLocation), 
+      m_Stream((GLsizeiptr)maxInstances * sizeof(InstanceData)), m_Current{nullptr, 0, 0}, m_Count(0) {
+
+    GLCall( glBindVertexArray(m_VAO) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, m_Stream.GetID()) );
+
+    // one attribute per transform row, then the color, all advancing once 
+    // per instance instead of once per vertex
+    for (GLuint row = 0; row < 3; row++) {
+        GLuint location = m_FirstLocation + row;
+        GLCall( glEnableVertexAttribArray(location) );
+        GLCall( glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), 
+            (const GLvoid*)(offsetof(InstanceData, Transform) + row * 4 * sizeof(float))) );
+        GLCall( glVertexAttribDivisor(location, 1) );
+    }
+    GLuint color = m_FirstLocation + 3;
+    GLCall( glEnableVertexAttribArray(color) );
+    GLCall( glVertexAttribPointer(color, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(InstanceData), 
+        (const GLvoid*)offsetof(InstanceData, Color)) );
+    GLCall( glVertexAttribDivisor(color, 1) );
+
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+    GLCall( glBindVertexArray(0) );
+}
+
+InstanceData* InstanceRenderer::Begin(uint32_t count) {
+    m_Count = count;
+    // nothing visible: nothing to stream, Draw() does nothing
+    if (count == 0) {
+        m_Current = { nullptr, 0, 0 };
+        return nullptr;
+    }
+    m_Current = m_Stream.Allocate((GLsizeiptr)count * sizeof(InstanceData), sizeof(InstanceData));
+    return (InstanceData*)m_Current.Data;
+}
+
+void InstanceRenderer::Draw(GLsizei indexCount, GLenum indexType, const GLvoid* indexOffset, 
+    GLenum mode) {
+    if (m_Count == 0)
+        return;
+    m_Stream.Commit(m_Current);
+
+    // the allocation is aligned to the instance size: offset / size is the 
+    // base instance, but glDrawElementsInstancedBaseInstance is GL 4.2, so 
+    // the attribute pointers are moved instead
+    GLCall( glBindVertexArray(m_VAO) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, m_Stream.GetID()) );
+    for (GLuint row = 0; row < 3; row++) {
+        GLCall( glVertexAttribPointer(m_FirstLocation + row, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), 
+            (const GLvoid*)(m_Current.Offset + offsetof(InstanceData, Transform) + row * 4 * sizeof(float))) );
+    }
+    GLCall( glVertexAttribPointer(m_FirstLocation + 3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(InstanceData), 
+        (const GLvoid*)(m_Current.Offset + offsetof(InstanceData, Color))) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+
+    GLCall( glDrawElementsInstanced(mode, indexCount, indexType, indexOffset, (GLsizei)m_Count) );
+}
+
+uint32_t InstanceRenderer::PackColor(float r, float g, float b, float a) {
+    auto channel = [](float value) {
+        return (uint32_t)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+    // RGBA in memory order on little endian
+    return channel(r) | (channel(g) << 8) | (channel(b) << 16) | (channel(a) << 24);
+}
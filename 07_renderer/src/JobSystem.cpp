@@ -0,0 +1,237 @@
+#include "JobSystem.h"
+
+#include <chrono>
+
+#include "Debug.h"
+
+
+// failed find attempts before an idle worker goes to sleep
+static const int SPIN_COUNT = 64;
+
+static thread_local const JobSystem* t_System = nullptr;
+static thread_local int t_Slot = -1;
+
+
+WorkStealingDeque::WorkStealingDeque(size_t capacity)
+    : m_Top(0), m_Bottom(0), m_Jobs(new std::atomic<Job*>[capacity]), m_Mask((int64_t)capacity - 1) {
+
+    ASSERT((capacity & (capacity - 1)) == 0);
+}
+
+bool WorkStealingDeque::Push(Job* job) {
+    int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+    int64_t top = m_Top.load(std::memory_order_acquire);
+    if (bottom - top > m_Mask)
+        return false;
+    m_Jobs[bottom & m_Mask].store(job, std::memory_order_relaxed);
+    // publishes the job contents to the thieves (acquire on m_Bottom)
+    m_Bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+Job* WorkStealingDeque::Pop() {
+    int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_Top.load(std::memory_order_relaxed);
+    if (top > bottom) {
+        // empty
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = m_Jobs[bottom & m_Mask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // last one: race against the thieves
+        if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = nullptr;
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkStealingDeque::Steal() {
+    int64_t top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+        return nullptr;
+
+    Job* job = m_Jobs[top & m_Mask].load(std::memory_order_relaxed);
+    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+    return job;
+}
+
+
+JobSystem::JobSystem(unsigned int threads)
+    : m_SharedCount(0), m_Queued(0), m_Sleeping(0), m_Quit(false),
+    m_PreviousSystem(t_System), m_PreviousSlot(t_Slot) {
+
+    if (!threads)
+        threads = GetWorkerCount();
+    for (unsigned int i = 0; i < threads; i++)
+        m_Slots.emplace_back(new Slot());
+
+    t_System = this;
+    t_Slot = 0;
+    for (unsigned int i = 1; i < threads; i++)
+        m_Threads.emplace_back(&JobSystem::WorkerLoop, this, (int)i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Quit = true;
+    }
+    m_Wake.notify_all();
+    for (std::thread& thread : m_Threads)
+        thread.join();
+
+    if (t_System == this) {
+        t_System = m_PreviousSystem;
+        t_Slot = m_PreviousSlot;
+    }
+}
+
+JobSystem& JobSystem::Get() {
+    static JobSystem system;
+    return system;
+}
+
+int JobSystem::GetSlot() const {
+    return t_System == this ? t_Slot : -1;
+}
+
+Job* JobSystem::Allocate() {
+    int slot = GetSlot();
+    if (slot >= 0) {
+        Slot& owner = *m_Slots[slot];
+        Job* job = &owner.Ring[owner.Next++ & (RingSize - 1)];
+        // more than RingSize jobs of this thread in flight: fall back to the heap
+        if (job->Free.load(std::memory_order_acquire)) {
+            job->Free.store(false, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    Job* job = new Job();
+    job->Free = false;
+    job->Heap = true;
+    return job;
+}
+
+void JobSystem::Submit(Job* job) {
+    int slot = GetSlot();
+    if (slot < 0 || !m_Slots[slot]->Deque.Push(job)) {
+        std::lock_guard<std::mutex> lock(m_SharedMutex);
+        m_Shared.push_back(job);
+        m_SharedCount++;
+    }
+
+    m_Queued++;
+    if (m_Sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Wake.notify_one();
+    }
+}
+
+void JobSystem::AddDependent(JobCounter& dependency, Job* job) {
+    {
+        std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+        if (!dependency.IsDone()) {
+            dependency.m_Dependents.push_back(job);
+            return;
+        }
+    }
+    Submit(job);
+}
+
+Job* JobSystem::Find(int slot) {
+    Job* job = slot >= 0 ? m_Slots[slot]->Deque.Pop() : nullptr;
+
+    if (!job && m_SharedCount.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(m_SharedMutex);
+        if (!m_Shared.empty()) {
+            job = m_Shared.front();
+            m_Shared.pop_front();
+            m_SharedCount--;
+        }
+    }
+
+    // steal, starting right after our slot so the thieves spread out
+    size_t count = m_Slots.size();
+    for (size_t i = 1; !job && i <= count; i++) {
+        size_t victim = ((size_t)(slot + 1) + i) % count;
+        if ((int)victim != slot)
+            job = m_Slots[victim]->Deque.Steal();
+    }
+
+    if (job)
+        m_Queued--;
+    return job;
+}
+
+void JobSystem::Execute(Job* job) {
+    job->Invoke(job->Storage);
+    job->Destroy(job->Storage);
+    JobCounter* counter = job->Counter;
+    if (job->Heap)
+        delete job;
+    else
+        job->Free.store(true, std::memory_order_release);
+
+    if (!counter)
+        return;
+    // not the last one: no lock
+    uint32_t pending = counter->m_Pending.load(std::memory_order_relaxed);
+    while (pending > 1) {
+        if (counter->m_Pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel))
+            return;
+    }
+
+    // the last one goes to zero under the lock, so the counter can't be
+    // destroyed (see ~JobCounter()) or get dependents while it's released
+    std::vector<Job*> dependents;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            dependents.swap(counter->m_Dependents);
+    }
+    for (Job* dependent : dependents)
+        Submit(dependent);
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    int slot = GetSlot();
+    while (!counter.IsDone()) {
+        if (Job* job = Find(slot))
+            Execute(job);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::WorkerLoop(int slot) {
+    t_System = this;
+    t_Slot = slot;
+
+    int idle = 0;
+    while (!m_Quit.load(std::memory_order_relaxed)) {
+        if (Job* job = Find(slot)) {
+            Execute(job);
+            idle = 0;
+            continue;
+        }
+        if (++idle < SPIN_COUNT) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_Sleeping++;
+        // the timeout only covers a wake up lost between Submit()'s check and the wait
+        m_Wake.wait_for(lock, std::chrono::milliseconds(1), [this]() { return m_Quit || m_Queued.load() > 0; });
+        m_Sleeping--;
+        idle = 0;
+    }
+}
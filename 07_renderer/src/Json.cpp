@@ -0,0 +1,178 @@
+#include "Json.h"
+
+#include <charconv>
+#include <iostream>
+
+
+static const JsonValue NULL_VALUE;
+
+const JsonValue& JsonValue::operator[](size_t index) const {
+    return index < m_Array.size() ? m_Array[index] : NULL_VALUE;
+}
+
+const JsonValue& JsonValue::operator[](const std::string& key) const {
+    auto it = m_Object.find(key);
+    return it == m_Object.end() ? NULL_VALUE : it->second;
+}
+
+/**
+ * @brief recursive descent parser over the text
+ */
+class JsonParser {
+public:
+    JsonParser(const char* text, size_t size) : m_Begin(text), m_P(text), m_End(text + size) {}
+
+    bool ParseDocument(JsonValue& value) {
+        if (!ParseValue(value, 0))
+            return Error();
+        SkipSpaces();
+        return m_P == m_End || Error();
+    }
+
+private:
+    static const int MAX_DEPTH = 64;
+
+    bool Error() {
+        std::cout << "[Json] syntax error at byte " << (m_P - m_Begin) << std::endl;
+        return false;
+    }
+
+    void SkipSpaces() {
+        while (m_P < m_End && (*m_P == ' ' || *m_P == '\t' || *m_P == '\n' || *m_P == '\r'))
+            m_P++;
+    }
+
+    bool Expect(char c) {
+        SkipSpaces();
+        if (m_P >= m_End || *m_P != c)
+            return false;
+        m_P++;
+        return true;
+    }
+
+    bool Literal(const char* word) {
+        for (; *word; word++, m_P++)
+            if (m_P >= m_End || *m_P != *word)
+                return false;
+        return true;
+    }
+
+    bool ParseString(std::string& out) {
+        if (!Expect('"'))
+            return false;
+        while (m_P < m_End && *m_P != '"') {
+            char c = *m_P++;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (m_P >= m_End)
+                return false;
+            char e = *m_P++;
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    // \uXXXX, written back as UTF-8 (surrogate pairs are not 
+                    // combined, glTF keys never need them)
+                    unsigned int code = 0;
+                    if (m_End - m_P < 4 || std::from_chars(m_P, m_P + 4, code, 16).ptr != m_P + 4)
+                        return false;
+                    m_P += 4;
+                    if (code < 0x80) {
+                        out += (char)code;
+                    } else if (code < 0x800) {
+                        out += (char)(0xC0 | (code >> 6));
+                        out += (char)(0x80 | (code & 0x3F));
+                    } else {
+                        out += (char)(0xE0 | (code >> 12));
+                        out += (char)(0x80 | ((code >> 6) & 0x3F));
+                        out += (char)(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: out += e; break;
+            }
+        }
+        if (m_P >= m_End)
+            return false;
+        m_P++;
+        return true;
+    }
+
+    bool ParseValue(JsonValue& value, int depth) {
+        if (depth > MAX_DEPTH)
+            return false;
+        SkipSpaces();
+        if (m_P >= m_End)
+            return false;
+
+        switch (*m_P) {
+            case '{': {
+                m_P++;
+                value.m_Type = JsonValue::Type::Object;
+                SkipSpaces();
+                if (m_P < m_End && *m_P == '}') {
+                    m_P++;
+                    return true;
+                }
+                do {
+                    std::string key;
+                    if (!ParseString(key) || !Expect(':') || !ParseValue(value.m_Object[key], depth + 1))
+                        return false;
+                } while (Expect(','));
+                return Expect('}');
+            }
+            case '[': {
+                m_P++;
+                value.m_Type = JsonValue::Type::Array;
+                SkipSpaces();
+                if (m_P < m_End && *m_P == ']') {
+                    m_P++;
+                    return true;
+                }
+                do {
+                    value.m_Array.emplace_back();
+                    if (!ParseValue(value.m_Array.back(), depth + 1))
+                        return false;
+                } while (Expect(','));
+                return Expect(']');
+            }
+            case '"':
+                value.m_Type = JsonValue::Type::String;
+                return ParseString(value.m_String);
+            case 't':
+                value.m_Type = JsonValue::Type::Bool;
+                value.m_Number = 1.0;
+                return Literal("true");
+            case 'f':
+                value.m_Type = JsonValue::Type::Bool;
+                value.m_Number = 0.0;
+                return Literal("false");
+            case 'n':
+                value.m_Type = JsonValue::Type::Null;
+                return Literal("null");
+            default: {
+                value.m_Type = JsonValue::Type::Number;
+                std::from_chars_result result = std::from_chars(m_P, m_End, value.m_Number);
+                if (result.ec != std::errc())
+                    return false;
+                m_P = result.ptr;
+                return true;
+            }
+        }
+    }
+
+    const char* m_Begin;
+    const char* m_P;
+    const char* m_End;
+};
+
+bool JsonValue::Parse(const char* text, size_t size, JsonValue& value) {
+    value = JsonValue();
+    JsonParser parser(text, size);
+    return parser.ParseDocument(value);
+}
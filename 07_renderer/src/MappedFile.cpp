@@ -0,0 +1,48 @@
+#include "MappedFile.h"
+
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+bool MappedFile::Open(const std::string& filePath) {
+    Close();
+
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "File does not exist: " << filePath << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        std::cout << "File is empty: " << filePath << std::endl;
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file alive
+    close(fd);
+    if (data == MAP_FAILED) {
+        std::cout << "Failed to map " << filePath << std::endl;
+        return false;
+    }
+
+    // we read front to back
+    madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+    m_Data = (const char*)data;
+    m_Size = (size_t)info.st_size;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_Data)
+        munmap((void*)m_Data, m_Size);
+    m_Data = nullptr;
+    m_Size = 0;
+}
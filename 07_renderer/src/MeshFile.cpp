@@ -0,0 +1,269 @@
+#include "MeshFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "IndexData.h"
+#include "MappedFile.h"
+
+
+static uint64_t AlignUp(uint64_t value) {
+    return (value + MESH_FILE_ALIGNMENT - 1) & ~(uint64_t)(MESH_FILE_ALIGNMENT - 1);
+}
+
+bool WriteMeshFile(const std::string& filePath, const void* vertices, uint32_t vertexCount, 
+    const VertexBufferLayout& layout, const GLuint* indices, uint32_t indexCount, 
+    const std::vector<MeshFileLod>& lods) {
+
+    const std::vector<VertexBufferElement>& elements = layout.GetElements();
+    if (elements.empty() || elements[0].Type != GL_FLOAT || elements[0].Count < 3) {
+        std::cout << "WriteMeshFile: the layout must start with a float position" << std::endl;
+        return false;
+    }
+
+    // no splitting, the LOD ranges index the stream as a whole
+    IndexData narrowed = NarrowIndices(indices, indexCount, false);
+
+    MeshFileHeader header = {};
+    header.Magic = MESH_FILE_MAGIC;
+    header.Version = MESH_FILE_VERSION;
+    header.VertexCount = vertexCount;
+    header.IndexCount = indexCount;
+    header.IndexType = narrowed.Type;
+    header.StreamCount = (uint32_t)elements.size();
+    header.LodCount = lods.empty() ? 1 : (uint32_t)lods.size();
+
+    // sections after the tables, all aligned
+    std::vector<MeshFileStream> streams(elements.size());
+    uint64_t offset = AlignUp(sizeof(MeshFileHeader) + sizeof(MeshFileStream) * streams.size() + 
+        sizeof(MeshFileLod) * header.LodCount);
+    for (size_t i = 0; i < elements.size(); i++) {
+        streams[i].Location = (uint32_t)i;
+        streams[i].Type = elements[i].Type;
+        streams[i].Count = (uint32_t)elements[i].Count;
+        streams[i].Normalized = elements[i].Normalized;
+        streams[i].Offset = offset;
+        streams[i].Size = (uint64_t)elements[i].GetSize() * vertexCount;
+        offset = AlignUp(offset + streams[i].Size);
+    }
+    header.IndexOffset = offset;
+    header.IndexSize = narrowed.Bytes.size();
+    header.FileSize = header.IndexOffset + header.IndexSize;
+
+    // bounds from the positions
+    const uint8_t* source = (const uint8_t*)vertices;
+    GLsizei stride = layout.GetStride();
+    for (int axis = 0; axis < 3; axis++) {
+        header.BoundsMin[axis] = vertexCount ? INFINITY : 0.0f;
+        header.BoundsMax[axis] = vertexCount ? -INFINITY : 0.0f;
+    }
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        float position[3];
+        memcpy(position, source + (size_t)v * stride, sizeof(position));
+        for (int axis = 0; axis < 3; axis++) {
+            header.BoundsMin[axis] = std::fmin(header.BoundsMin[axis], position[axis]);
+            header.BoundsMax[axis] = std::fmax(header.BoundsMax[axis], position[axis]);
+        }
+    }
+    float radius2 = 0.0f;
+    for (int axis = 0; axis < 3; axis++)
+        header.Center[axis] = (header.BoundsMin[axis] + header.BoundsMax[axis]) * 0.5f;
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        float position[3];
+        memcpy(position, source + (size_t)v * stride, sizeof(position));
+        float dx = position[0] - header.Center[0];
+        float dy = position[1] - header.Center[1];
+        float dz = position[2] - header.Center[2];
+        radius2 = std::fmax(radius2, dx * dx + dy * dy + dz * dz);
+    }
+    header.Radius = std::sqrt(radius2);
+
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file) {
+        std::cout << "Failed to write " << filePath << std::endl;
+        return false;
+    }
+
+    static const char padding[MESH_FILE_ALIGNMENT] = {};
+    auto padTo = [&file](uint64_t position) {
+        uint64_t current = (uint64_t)file.tellp();
+        file.write(padding, (std::streamsize)(position - current));
+    };
+
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)streams.data(), (std::streamsize)(sizeof(MeshFileStream) * streams.size()));
+    if (lods.empty()) {
+        MeshFileLod lod = { 0, indexCount, 0.0f, 0 };
+        file.write((const char*)&lod, sizeof(lod));
+    } else {
+        file.write((const char*)lods.data(), (std::streamsize)(sizeof(MeshFileLod) * lods.size()));
+    }
+
+    // deinterleave, one attribute at a time
+    std::vector<uint8_t> stream;
+    GLsizei elementOffset = 0;
+    for (size_t i = 0; i < elements.size(); i++) {
+        GLsizei size = elements[i].GetSize();
+        stream.resize((size_t)size * vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++)
+            memcpy(&stream[(size_t)v * size], source + (size_t)v * stride + elementOffset, size);
+        elementOffset += size;
+
+        padTo(streams[i].Offset);
+        file.write((const char*)stream.data(), (std::streamsize)stream.size());
+    }
+
+    padTo(header.IndexOffset);
+    file.write((const char*)narrowed.Bytes.data(), (std::streamsize)narrowed.Bytes.size());
+
+    if (!file) {
+        std::cout << "Failed to write " << filePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool IsAttributeType(uint32_t type) {
+    switch (type) {
+        case GL_FLOAT: case GL_HALF_FLOAT: case GL_INT: case GL_UNSIGNED_INT: 
+        case GL_SHORT: case GL_UNSIGNED_SHORT: case GL_BYTE: case GL_UNSIGNED_BYTE:
+        case GL_INT_2_10_10_10_REV: case GL_UNSIGNED_INT_2_10_10_10_REV:
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief everything Load() relies on, a truncated or foreign file must not 
+ * make us read past the mapping
+ */
+static bool ValidateMeshFile(const char* data, size_t size, const MeshFileHeader& header) {
+    if (header.Magic != MESH_FILE_MAGIC || header.Version != MESH_FILE_VERSION || header.FileSize > size)
+        return false;
+    if (header.IndexType != GL_UNSIGNED_BYTE && header.IndexType != GL_UNSIGNED_SHORT && 
+        header.IndexType != GL_UNSIGNED_INT)
+        return false;
+    if (header.StreamCount == 0 || header.LodCount == 0)
+        return false;
+
+    uint64_t tables = sizeof(MeshFileHeader) + (uint64_t)sizeof(MeshFileStream) * header.StreamCount + 
+        (uint64_t)sizeof(MeshFileLod) * header.LodCount;
+    if (tables > header.IndexOffset)
+        return false;
+    if (header.IndexOffset + header.IndexSize > header.FileSize || 
+        (uint64_t)header.IndexCount * GetIndexSize(header.IndexType) != header.IndexSize)
+        return false;
+
+    const MeshFileStream* streams = (const MeshFileStream*)(data + sizeof(MeshFileHeader));
+    for (uint32_t i = 0; i < header.StreamCount; i++) {
+        if (!IsAttributeType(streams[i].Type))
+            return false;
+        VertexBufferElement element = { streams[i].Type, (GLint)streams[i].Count, GL_FALSE };
+        if (streams[i].Count < 1 || streams[i].Count > 4 || streams[i].Offset < tables || 
+            streams[i].Offset + streams[i].Size > header.IndexOffset || 
+            streams[i].Size != (uint64_t)element.GetSize() * header.VertexCount)
+            return false;
+    }
+
+    const MeshFileLod* lods = (const MeshFileLod*)(streams + header.StreamCount);
+    for (uint32_t i = 0; i < header.LodCount; i++) {
+        if ((uint64_t)lods[i].FirstIndex + lods[i].IndexCount > header.IndexCount)
+            return false;
+    }
+    return true;
+}
+
+bool MeshFile::Load(const std::string& filePath) {
+    Release();
+
+    MappedFile file;
+    if (!file.Open(filePath))
+        return false;
+    const char* data = file.GetData();
+
+    if (file.GetSize() < sizeof(MeshFileHeader)) {
+        std::cout << filePath << " is not a .mesh file" << std::endl;
+        return false;
+    }
+    memcpy(&m_Header, data, sizeof(MeshFileHeader));
+    if (!ValidateMeshFile(data, file.GetSize(), m_Header)) {
+        std::cout << filePath << " is not a valid .mesh v" << MESH_FILE_VERSION << " file" << std::endl;
+        m_Header = MeshFileHeader();
+        return false;
+    }
+
+    std::vector<MeshFileStream> streams(m_Header.StreamCount);
+    memcpy(streams.data(), data + sizeof(MeshFileHeader), sizeof(MeshFileStream) * streams.size());
+    m_Lods.resize(m_Header.LodCount);
+    memcpy(m_Lods.data(), data + sizeof(MeshFileHeader) + sizeof(MeshFileStream) * streams.size(), 
+        sizeof(MeshFileLod) * m_Lods.size());
+
+    // the streams are back to back, one upload from the first to the last
+    uint64_t vertexBegin = streams[0].Offset, vertexEnd = 0;
+    for (const MeshFileStream& stream : streams) {
+        vertexBegin = std::min(vertexBegin, stream.Offset);
+        vertexEnd = std::max(vertexEnd, stream.Offset + stream.Size);
+    }
+
+    GLCall( glGenVertexArrays(1, &m_VAO) );
+    GLCall( glBindVertexArray(m_VAO) );
+
+    GLCall( glGenBuffers(1, &m_VertexBuffer) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffer) );
+    GLCall( glGenBuffers(1, &m_IndexBuffer) );
+    GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer) );
+    if (GLEW_ARB_buffer_storage) {
+        GLCall( glBufferStorage(GL_ARRAY_BUFFER, vertexEnd - vertexBegin, data + vertexBegin, 0) );
+        GLCall( glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, m_Header.IndexSize, data + m_Header.IndexOffset, 0) );
+    } else {
+        GLCall( glBufferData(GL_ARRAY_BUFFER, vertexEnd - vertexBegin, data + vertexBegin, GL_STATIC_DRAW) );
+        GLCall( glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Header.IndexSize, data + m_Header.IndexOffset, 
+            GL_STATIC_DRAW) );
+    }
+
+    for (const MeshFileStream& stream : streams) {
+        GLCall( glEnableVertexAttribArray(stream.Location) );
+        GLCall( glVertexAttribPointer(stream.Location, stream.Count, stream.Type, 
+            stream.Normalized ? GL_TRUE : GL_FALSE, 0, (const GLvoid*)(stream.Offset - vertexBegin)) );
+    }
+
+    GLCall( glBindVertexArray(0) );
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+    return true;
+}
+
+void MeshFile::Release() {
+    if (m_VAO)
+        glDeleteVertexArrays(1, &m_VAO);
+    if (m_VertexBuffer)
+        glDeleteBuffers(1, &m_VertexBuffer);
+    if (m_IndexBuffer)
+        glDeleteBuffers(1, &m_IndexBuffer);
+    m_VAO = m_VertexBuffer = m_IndexBuffer = 0;
+    m_Lods.clear();
+}
+
+void MeshFile::Draw(unsigned int lod, GLenum mode) const {
+    ASSERT(lod < m_Lods.size());
+    const MeshFileLod& range = m_Lods[lod];
+    GLCall( glBindVertexArray(m_VAO) );
+    GLCall( glDrawElements(mode, range.IndexCount, m_Header.IndexType, 
+        (const GLvoid*)((GLintptr)range.FirstIndex * GetIndexSize(m_Header.IndexType))) );
+}
+
+unsigned int SelectLod(const std::vector<MeshFileLod>& lods, float distance, float projectionScale, 
+    unsigned int current, float threshold, float hysteresis) {
+
+    float pixelsPerUnit = projectionScale / std::max(distance, 1e-4f);
+    unsigned int lod = 0;
+    while (lod + 1 < lods.size() && lods[lod + 1].Error * pixelsPerUnit <= threshold)
+        lod++;
+
+    // finer right away, coarser only once clearly past the boundary
+    while (lod > current && lods[lod].Error * pixelsPerUnit > threshold * (1.0f - hysteresis))
+        lod--;
+    return lod;
+}
@@ -0,0 +1,313 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+
+// the fetch analysis simulates a direct mapped cache of 64 bytes lines
+static const size_t CACHE_LINE = 64;
+static const size_t CACHE_LINES = 256;
+
+/**
+ * @brief FIFO post-transform cache, as assumed by Tipsify
+ */
+class FifoCache {
+public:
+    FifoCache(size_t vertexCount, unsigned int size) 
+        : m_Timestamps(vertexCount, 0), m_Time(size + 1), m_Size(size) {}
+
+    // true on a miss
+    bool Access(GLuint vertex) {
+        if (m_Time - m_Timestamps[vertex] <= m_Size)
+            return false;
+        m_Timestamps[vertex] = m_Time++;
+        return true;
+    }
+
+private:
+    std::vector<unsigned int> m_Timestamps;
+    unsigned int m_Time;
+    unsigned int m_Size;
+};
+
+VertexCacheStats AnalyzeVertexCache(const GLuint* indices, size_t indexCount, size_t vertexCount, 
+    unsigned int cacheSize) {
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> used(vertexCount, false);
+    size_t misses = 0, unique = 0;
+
+    for (size_t i = 0; i < indexCount; i++) {
+        misses += cache.Access(indices[i]);
+        if (!used[indices[i]]) {
+            used[indices[i]] = true;
+            unique++;
+        }
+    }
+
+    VertexCacheStats stats;
+    stats.ACMR = indexCount ? (float)misses / (float)(indexCount / 3) : 0.0f;
+    stats.ATVR = unique ? (float)misses / (float)unique : 0.0f;
+    return stats;
+}
+
+VertexFetchStats AnalyzeVertexFetch(const GLuint* indices, size_t indexCount, size_t vertexCount, 
+    size_t vertexSize) {
+
+    // only the vertices missing the post-transform cache are fetched
+    FifoCache cache(vertexCount, 16);
+    std::vector<size_t> lines(CACHE_LINES, (size_t)-1);
+    std::vector<bool> used(vertexCount, false);
+    size_t fetched = 0, unique = 0;
+
+    for (size_t i = 0; i < indexCount; i++) {
+        GLuint vertex = indices[i];
+        if (!used[vertex]) {
+            used[vertex] = true;
+            unique++;
+        }
+        if (!cache.Access(vertex))
+            continue;
+
+        size_t first = vertex * vertexSize / CACHE_LINE;
+        size_t last = (vertex * vertexSize + vertexSize - 1) / CACHE_LINE;
+        for (size_t line = first; line <= last; line++) {
+            if (lines[line % CACHE_LINES] != line) {
+                lines[line % CACHE_LINES] = line;
+                fetched += CACHE_LINE;
+            }
+        }
+    }
+
+    VertexFetchStats stats;
+    stats.BytesFetched = fetched;
+    stats.OverfetchRatio = unique ? (float)fetched / (float)(unique * vertexSize) : 0.0f;
+    return stats;
+}
+
+void OptimizeVertexCache(GLuint* destination, const GLuint* indices, size_t indexCount, 
+    size_t vertexCount, unsigned int cacheSize) {
+
+    size_t triangleCount = indexCount / 3;
+
+    // vertex -> triangles adjacency, in CSR form
+    std::vector<unsigned int> liveTriangles(vertexCount, 0);
+    for (size_t i = 0; i < indexCount; i++)
+        liveTriangles[indices[i]]++;
+
+    std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+    std::vector<size_t> adjacency(indexCount);
+    std::vector<size_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++)
+        for (int k = 0; k < 3; k++)
+            adjacency[fill[indices[t * 3 + k]]++] = t;
+
+    std::vector<unsigned int> timestamps(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<GLuint> deadEnd;    // recently used vertices, to restart from
+    std::vector<GLuint> candidates;
+
+    unsigned int time = cacheSize + 1;
+    size_t cursor = 0;              // next vertex in input order for restarts
+    size_t output = 0;
+
+    long fanning = vertexCount ? 0 : -1;
+    while (fanning >= 0) {
+        candidates.clear();
+
+        // emit all the triangles around the fanning vertex
+        for (size_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; a++) {
+            size_t t = adjacency[a];
+            if (emitted[t])
+                continue;
+            emitted[t] = true;
+
+            for (int k = 0; k < 3; k++) {
+                GLuint v = indices[t * 3 + k];
+                destination[output++] = v;
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                liveTriangles[v]--;
+                if (time - timestamps[v] > cacheSize)
+                    timestamps[v] = time++;
+            }
+        }
+
+        // next fanning vertex: the candidate that will still be in cache 
+        // after its remaining triangles, and that has been there the longest
+        long best = -1;
+        int bestPriority = -1;
+        for (GLuint v : candidates) {
+            if (liveTriangles[v] == 0)
+                continue;
+            int priority = 0;
+            if (time - timestamps[v] + 2 * liveTriangles[v] <= cacheSize)
+                priority = (int)(time - timestamps[v]);
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = v;
+            }
+        }
+
+        if (best < 0) {
+            // dead end: go back to a recent vertex, then to the input order
+            while (!deadEnd.empty() && best < 0) {
+                GLuint v = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveTriangles[v] > 0)
+                    best = v;
+            }
+            while (best < 0 && cursor < vertexCount) {
+                if (liveTriangles[cursor] > 0)
+                    best = (long)cursor;
+                cursor++;
+            }
+        }
+        fanning = best;
+    }
+}
+
+void OptimizeOverdraw(GLuint* destination, const GLuint* indices, size_t indexCount, 
+    const float* positions, size_t vertexCount, size_t vertexStride, float threshold, 
+    unsigned int cacheSize) {
+
+    size_t triangleCount = indexCount / 3;
+    size_t floatStride = vertexStride / sizeof(float);
+    if (triangleCount == 0)
+        return;
+
+    // split in clusters where the cache restarts (a triangle with 3 
+    // misses), or where the cluster is already as good as the threshold 
+    // allows, so the reordering costs little ACMR
+    float meshACMR = AnalyzeVertexCache(indices, indexCount, vertexCount, cacheSize).ACMR;
+    std::vector<size_t> clusters;
+    FifoCache cache(vertexCount, cacheSize);
+    size_t clusterMisses = 0, clusterStart = 0;
+
+    for (size_t t = 0; t < triangleCount; t++) {
+        int misses = 0;
+        for (int k = 0; k < 3; k++)
+            misses += cache.Access(indices[t * 3 + k]);
+
+        size_t clusterTriangles = t - clusterStart;
+        bool hard = misses == 3;
+        bool soft = misses >= 2 && clusterTriangles > 0 && 
+            (float)clusterMisses / (float)clusterTriangles <= meshACMR * threshold;
+        if (t == 0 || hard || soft) {
+            clusters.push_back(t);
+            clusterStart = t;
+            clusterMisses = 0;
+        }
+        clusterMisses += misses;
+    }
+    clusters.push_back(triangleCount);
+
+    // area weighted centroid and normal of the mesh and of every cluster
+    struct Cluster { size_t Begin, End; float Sort; };
+    std::vector<Cluster> sorted;
+    std::vector<float> data((clusters.size() - 1) * 7, 0.0f);
+    float mesh[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    for (size_t c = 0; c + 1 < clusters.size(); c++) {
+        float* cluster = &data[c * 7];
+        for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+            const float* p0 = positions + indices[t * 3 + 0] * floatStride;
+            const float* p1 = positions + indices[t * 3 + 1] * floatStride;
+            const float* p2 = positions + indices[t * 3 + 2] * floatStride;
+            float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], 
+                e1[0] * e2[1] - e1[1] * e2[0]};
+            float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            for (int k = 0; k < 3; k++) {
+                float centroid = (p0[k] + p1[k] + p2[k]) / 3.0f;
+                cluster[k] += centroid * area;
+                cluster[3 + k] += n[k];
+                mesh[k] += centroid * area;
+            }
+            cluster[6] += area;
+            mesh[3] += area;
+        }
+    }
+
+    for (size_t c = 0; c + 1 < clusters.size(); c++) {
+        float* cluster = &data[c * 7];
+        float sort = 0.0f;
+        if (cluster[6] > 0.0f && mesh[3] > 0.0f) {
+            float length = std::sqrt(cluster[3] * cluster[3] + cluster[4] * cluster[4] + 
+                cluster[5] * cluster[5]);
+            for (int k = 0; k < 3 && length > 0.0f; k++)
+                sort += (cluster[k] / cluster[6] - mesh[k] / mesh[3]) * cluster[3 + k] / length;
+        }
+        sorted.push_back({clusters[c], clusters[c + 1], sort});
+    }
+
+    // outward facing first: they are the likely occluders
+    std::stable_sort(sorted.begin(), sorted.end(), 
+        [](const Cluster& a, const Cluster& b) { return a.Sort > b.Sort; });
+
+    size_t output = 0;
+    for (const Cluster& cluster : sorted)
+        for (size_t i = cluster.Begin * 3; i < cluster.End * 3; i++)
+            destination[output++] = indices[i];
+}
+
+size_t OptimizeVertexFetch(void* destination, GLuint* indices, size_t indexCount, 
+    const void* vertices, size_t vertexCount, size_t vertexSize) {
+
+    const GLuint unused = 0xFFFFFFFF;
+    std::vector<GLuint> remap(vertexCount, unused);
+    size_t next = 0;
+
+    for (size_t i = 0; i < indexCount; i++) {
+        GLuint& target = remap[indices[i]];
+        if (target == unused) {
+            memcpy((uint8_t*)destination + next * vertexSize, 
+                (const uint8_t*)vertices + (size_t)indices[i] * vertexSize, vertexSize);
+            target = (GLuint)next++;
+        }
+        indices[i] = target;
+    }
+    return next;
+}
+
+MeshOptimizationReport OptimizeMesh(std::vector<uint8_t>& vertices, std::vector<GLuint>& indices, 
+    const VertexBufferLayout& layout) {
+
+    ASSERT(!layout.GetElements().empty() && layout.GetElements()[0].Type == GL_FLOAT && 
+        layout.GetElements()[0].Count >= 3);
+
+    size_t stride = layout.GetStride();
+    size_t vertexCount = vertices.size() / stride;
+
+    MeshOptimizationReport report;
+    report.CacheBefore = AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+    report.FetchBefore = AnalyzeVertexFetch(indices.data(), indices.size(), vertexCount, stride);
+
+    std::vector<GLuint> reordered(indices.size());
+    OptimizeVertexCache(reordered.data(), indices.data(), indices.size(), vertexCount);
+    OptimizeOverdraw(indices.data(), reordered.data(), reordered.size(), 
+        (const float*)vertices.data(), vertexCount, stride);
+
+    std::vector<uint8_t> remapped(vertices.size());
+    size_t used = OptimizeVertexFetch(remapped.data(), indices.data(), indices.size(), 
+        vertices.data(), vertexCount, stride);
+    remapped.resize(used * stride);
+    vertices.swap(remapped);
+
+    report.CacheAfter = AnalyzeVertexCache(indices.data(), indices.size(), used);
+    report.FetchAfter = AnalyzeVertexFetch(indices.data(), indices.size(), used, stride);
+    return report;
+}
+
+void PrintMeshOptimizationReport(const MeshOptimizationReport& report) {
+    std::cout << "[MeshOptimizer] ACMR " << report.CacheBefore.ACMR << " -> " << report.CacheAfter.ACMR 
+        << ", ATVR " << report.CacheBefore.ATVR << " -> " << report.CacheAfter.ATVR 
+        << ", overfetch " << report.FetchBefore.OverfetchRatio << " -> " << report.FetchAfter.OverfetchRatio 
+        << std::endl;
+}
@@ -0,0 +1,213 @@
+#include "MeshPool.h"
+
+#include <algorithm>
+
+
+// smallest ranges handed out by the page allocators
+static const uint32_t MIN_VERTEX_BLOCK = 16;   // vertices
+static const uint32_t MIN_INDEX_BLOCK = 64;    // bytes
+
+MeshPool::MeshPool(const VertexBufferLayout& layout, uint32_t verticesPerPage, uint32_t indicesPerPage)
+    : m_Layout(layout), m_VerticesPerPage(verticesPerPage), 
+      m_IndexBytesPerPage(indicesPerPage * sizeof(GLuint)), m_BoundPage(0xFFFFFFFF) {
+}
+
+MeshPool::~MeshPool() {
+    for (Page& page : m_Pages) {
+        glDeleteVertexArrays(1, &page.VAO);
+        glDeleteBuffers(1, &page.VBO);
+        glDeleteBuffers(1, &page.IBO);
+    }
+}
+
+uint32_t MeshPool::CreatePage(uint32_t vertexCapacity, uint32_t indexBytes) {
+    m_Pages.push_back({0, 0, 0, BuddyAllocator(vertexCapacity, MIN_VERTEX_BLOCK), 
+        BuddyAllocator(indexBytes, MIN_INDEX_BLOCK), {}, {}});
+    Page& page = m_Pages.back();
+
+    GLCall( glGenVertexArrays(1, &page.VAO) );
+    GLCall( glGenBuffers(1, &page.VBO) );
+    GLCall( glGenBuffers(1, &page.IBO) );
+
+    GLCall( glBindVertexArray(page.VAO) );
+
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, page.VBO) );
+    GLCall( glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)page.Vertices.GetCapacity() * m_Layout.GetStride(), 
+        nullptr, GL_STATIC_DRAW) );
+    m_Layout.Apply();
+
+    GLCall( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.IBO) );
+    GLCall( glBufferData(GL_ELEMENT_ARRAY_BUFFER, page.Indices.GetCapacity(), nullptr, GL_STATIC_DRAW) );
+
+    GLCall( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+    GLCall( glBindVertexArray(0) );
+    m_BoundPage = 0xFFFFFFFF;
+
+    return (uint32_t)m_Pages.size() - 1;
+}
+
+MeshPool::MeshHandle MeshPool::Add(const void* vertices, uint32_t vertexCount, const GLuint* indices, 
+    uint32_t indexCount) {
+
+    // nothing to draw, and the allocators don't hand out empty ranges
+    if (vertexCount == 0 || indexCount == 0)
+        return InvalidMesh;
+
+    IndexData indexData = NarrowIndices(indices, indexCount);
+    uint32_t indexBytes = (uint32_t)indexData.Bytes.size();
+
+    // first page with room for both the vertices and the indices
+    uint32_t pageIndex = 0;
+    uint32_t vertexOffset = BuddyAllocator::InvalidOffset;
+    uint32_t indexOffset = BuddyAllocator::InvalidOffset;
+    for (; pageIndex < m_Pages.size(); pageIndex++) {
+        Page& page = m_Pages[pageIndex];
+        vertexOffset = page.Vertices.Allocate(vertexCount);
+        if (vertexOffset == BuddyAllocator::InvalidOffset)
+            continue;
+        indexOffset = page.Indices.Allocate(indexBytes);
+        if (indexOffset != BuddyAllocator::InvalidOffset)
+            break;
+        page.Vertices.Free(vertexOffset);
+    }
+
+    if (pageIndex == m_Pages.size()) {
+        // a mesh bigger than a page gets a page of its own
+        pageIndex = CreatePage(std::max(vertexCount, m_VerticesPerPage), 
+            std::max(indexBytes, m_IndexBytesPerPage));
+        vertexOffset = m_Pages[pageIndex].Vertices.Allocate(vertexCount);
+        indexOffset = m_Pages[pageIndex].Indices.Allocate(indexBytes);
+        ASSERT(vertexOffset != BuddyAllocator::InvalidOffset && indexOffset != BuddyAllocator::InvalidOffset);
+    }
+    Page& page = m_Pages[pageIndex];
+
+    // upload through the copy target, the page VAO is left untouched
+    GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, page.VBO) );
+    GLCall( glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)vertexOffset * m_Layout.GetStride(), 
+        (GLsizeiptr)vertexCount * m_Layout.GetStride(), vertices) );
+    GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, page.IBO) );
+    GLCall( glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset, indexBytes, indexData.Bytes.data()) );
+    GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, 0) );
+
+    MeshHandle mesh;
+    if (!m_FreeHandles.empty()) {
+        mesh = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+    } else {
+        mesh = (MeshHandle)m_Meshes.size();
+        m_Meshes.emplace_back();
+    }
+    m_Meshes[mesh] = {pageIndex, (GLint)vertexOffset, vertexCount, (GLintptr)indexOffset, 
+        (GLsizei)indexCount, indexData.Type, std::move(indexData.Chunks)};
+
+    page.VertexOwners[vertexOffset] = mesh;
+    page.IndexOwners[indexOffset] = mesh;
+
+    return mesh;
+}
+
+void MeshPool::Remove(MeshHandle mesh) {
+    if (mesh == InvalidMesh)
+        return;
+    MeshInfo& info = m_Meshes[mesh];
+    Page& page = m_Pages[info.Page];
+
+    page.Vertices.Free((uint32_t)info.BaseVertex);
+    page.Indices.Free((uint32_t)info.IndexOffset);
+    page.VertexOwners.erase((uint32_t)info.BaseVertex);
+    page.IndexOwners.erase((uint32_t)info.IndexOffset);
+
+    info.IndexCount = 0;
+    info.Chunks.clear();
+    m_FreeHandles.push_back(mesh);
+}
+
+void MeshPool::BindPage(uint32_t page) {
+    if (page == m_BoundPage)
+        return;
+    GLCall( glBindVertexArray(m_Pages[page].VAO) );
+    m_BoundPage = page;
+}
+
+void MeshPool::Unbind() {
+    GLCall( glBindVertexArray(0) );
+    m_BoundPage = 0xFFFFFFFF;
+}
+
+void MeshPool::Draw(MeshHandle mesh, GLenum mode) {
+    if (mesh == InvalidMesh)
+        return;
+    const MeshInfo& info = m_Meshes[mesh];
+    BindPage(info.Page);
+    for (const IndexChunk& chunk : info.Chunks) {
+        GLCall( glDrawElementsBaseVertex(mode, chunk.Count, info.IndexType, 
+            (const GLvoid*)(info.IndexOffset + chunk.ByteOffset), info.BaseVertex + chunk.BaseVertex) );
+    }
+}
+
+uint32_t MeshPool::DrawMulti(const MeshHandle* meshes, uint32_t count, DrawCommandBuilder& builder, 
+    GLenum mode) {
+
+    uint32_t calls = 0;
+    for (uint32_t page = 0; page < m_Pages.size(); page++) {
+        builder.Reset();
+        for (uint32_t i = 0; i < count; i++) {
+            if (meshes[i] == InvalidMesh)
+                continue;
+            const MeshInfo& info = m_Meshes[meshes[i]];
+            if (info.Page != page)
+                continue;
+            for (const IndexChunk& chunk : info.Chunks)
+                builder.Add(chunk.Count, info.IndexType, info.IndexOffset + chunk.ByteOffset, 
+                    info.BaseVertex + chunk.BaseVertex);
+        }
+        if (builder.GetCommandCount() == 0)
+            continue;
+        BindPage(page);
+        calls += builder.Submit(mode);
+    }
+    return calls;
+}
+
+uint32_t MeshPool::Defragment(uint32_t maxMoves) {
+    uint32_t moved = 0;
+    GLsizeiptr stride = m_Layout.GetStride();
+
+    for (Page& page : m_Pages) {
+        // ranges of the same size are aligned to their size in a buddy 
+        // allocator, source and destination never overlap
+        std::vector<BuddyAllocator::Move> moves = page.Vertices.Defragment(maxMoves);
+        if (!moves.empty()) {
+            GLCall( glBindBuffer(GL_COPY_READ_BUFFER, page.VBO) );
+            GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, page.VBO) );
+        }
+        for (const BuddyAllocator::Move& move : moves) {
+            GLCall( glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 
+                move.From * stride, move.To * stride, move.Size * stride) );
+            MeshHandle mesh = page.VertexOwners[move.From];
+            page.VertexOwners.erase(move.From);
+            page.VertexOwners[move.To] = mesh;
+            m_Meshes[mesh].BaseVertex = (GLint)move.To;
+        }
+        moved += (uint32_t)moves.size();
+
+        moves = page.Indices.Defragment(maxMoves);
+        if (!moves.empty()) {
+            GLCall( glBindBuffer(GL_COPY_READ_BUFFER, page.IBO) );
+            GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, page.IBO) );
+        }
+        for (const BuddyAllocator::Move& move : moves) {
+            GLCall( glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 
+                move.From, move.To, move.Size) );
+            MeshHandle mesh = page.IndexOwners[move.From];
+            page.IndexOwners.erase(move.From);
+            page.IndexOwners[move.To] = mesh;
+            m_Meshes[mesh].IndexOffset = (GLintptr)move.To;
+        }
+        moved += (uint32_t)moves.size();
+    }
+
+    GLCall( glBindBuffer(GL_COPY_READ_BUFFER, 0) );
+    GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, 0) );
+    return moved;
+}
@@ -0,0 +1,268 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include "MeshOptimizer.h"
+
+
+/**
+ * @brief sum of squared distances to a set of planes, weighted by the area 
+ * of the triangles the planes come from
+ */
+struct Quadric {
+    float A00, A01, A02, A11, A12, A22;
+    float B0, B1, B2;
+    float C;
+    float Weight;
+
+    void AddPlane(const float n[3], float d, float weight) {
+        A00 += weight * n[0] * n[0]; A01 += weight * n[0] * n[1]; A02 += weight * n[0] * n[2];
+        A11 += weight * n[1] * n[1]; A12 += weight * n[1] * n[2]; A22 += weight * n[2] * n[2];
+        B0 += weight * d * n[0]; B1 += weight * d * n[1]; B2 += weight * d * n[2];
+        C += weight * d * d;
+        Weight += weight;
+    }
+
+    void Add(const Quadric& other) {
+        A00 += other.A00; A01 += other.A01; A02 += other.A02;
+        A11 += other.A11; A12 += other.A12; A22 += other.A22;
+        B0 += other.B0; B1 += other.B1; B2 += other.B2;
+        C += other.C;
+        Weight += other.Weight;
+    }
+
+    /**
+     * @brief RMS distance of p to the planes
+     */
+    float Error(const float p[3]) const {
+        float x = p[0], y = p[1], z = p[2];
+        float q = A00 * x * x + A11 * y * y + A22 * z * z 
+            + 2.0f * (A01 * x * y + A02 * x * z + A12 * y * z) 
+            + 2.0f * (B0 * x + B1 * y + B2 * z) + C;
+        return Weight > 0.0f ? std::sqrt(std::max(q, 0.0f) / Weight) : 0.0f;
+    }
+};
+
+struct Collapse {
+    GLuint From, To;
+    float Error;
+};
+
+static const float* Position(const float* positions, size_t stride, GLuint vertex) {
+    return (const float*)((const char*)positions + vertex * stride);
+}
+
+static void Normal(const float* a, const float* b, const float* c, float n[3]) {
+    float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+/**
+ * @brief vertices that must stay: the ones sharing their position with 
+ * another vertex (uv/normal seams) and the ones on an open border
+ */
+static std::vector<bool> FindLockedVertices(const GLuint* indices, size_t indexCount, 
+    const float* positions, size_t vertexCount, size_t stride) {
+
+    struct PositionHash {
+        size_t operator()(const std::array<uint32_t, 3>& p) const {
+            return (p[0] * 73856093u) ^ (p[1] * 19349663u) ^ (p[2] * 83492791u);
+        }
+    };
+
+    std::vector<bool> locked(vertexCount, false);
+    std::vector<GLuint> wedge(vertexCount);
+    std::unordered_map<std::array<uint32_t, 3>, GLuint, PositionHash> firstByPosition;
+    firstByPosition.reserve(vertexCount);
+    for (GLuint v = 0; v < vertexCount; v++) {
+        std::array<uint32_t, 3> key;
+        memcpy(key.data(), Position(positions, stride, v), sizeof(key));
+        auto inserted = firstByPosition.emplace(key, v);
+        wedge[v] = inserted.first->second;
+        if (!inserted.second) {
+            locked[v] = true;
+            locked[wedge[v]] = true;
+        }
+    }
+
+    // an edge of a closed surface is shared by two triangles
+    std::unordered_map<uint64_t, unsigned int> edges;
+    edges.reserve(indexCount);
+    for (size_t i = 0; i < indexCount; i += 3) {
+        for (int e = 0; e < 3; e++) {
+            GLuint a = wedge[indices[i + e]], b = wedge[indices[i + (e + 1) % 3]];
+            edges[((uint64_t)std::min(a, b) << 32) | std::max(a, b)]++;
+        }
+    }
+    for (size_t i = 0; i < indexCount; i += 3) {
+        for (int e = 0; e < 3; e++) {
+            GLuint a = indices[i + e], b = indices[i + (e + 1) % 3];
+            GLuint wa = wedge[a], wb = wedge[b];
+            if (edges[((uint64_t)std::min(wa, wb) << 32) | std::max(wa, wb)] == 1)
+                locked[a] = locked[b] = true;
+        }
+    }
+    return locked;
+}
+
+size_t SimplifyMesh(GLuint* destination, const GLuint* indices, size_t indexCount, 
+    const float* positions, size_t vertexCount, size_t vertexStride, size_t targetIndexCount, 
+    float targetError, float* resultError) {
+
+    std::vector<GLuint> current(indices, indices + indexCount);
+    std::vector<bool> locked = FindLockedVertices(indices, indexCount, positions, vertexCount, vertexStride);
+
+    std::vector<Quadric> quadrics(vertexCount, Quadric());
+    for (size_t i = 0; i < indexCount; i += 3) {
+        const float* a = Position(positions, vertexStride, indices[i]);
+        float n[3];
+        Normal(a, Position(positions, vertexStride, indices[i + 1]), 
+            Position(positions, vertexStride, indices[i + 2]), n);
+        float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length == 0.0f)
+            continue;
+        n[0] /= length; n[1] /= length; n[2] /= length;
+        float d = -(n[0] * a[0] + n[1] * a[1] + n[2] * a[2]);
+        for (int k = 0; k < 3; k++)
+            quadrics[indices[i + k]].AddPlane(n, d, length * 0.5f);
+    }
+
+    float error = 0.0f;
+    std::vector<GLuint> adjacencyOffsets(vertexCount + 1), adjacency;
+    std::vector<Collapse> collapses;
+    std::vector<GLuint> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+
+    while (current.size() > targetIndexCount) {
+        size_t triangleCount = current.size() / 3;
+
+        // triangles around each vertex
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (GLuint index : current)
+            adjacencyOffsets[index + 1]++;
+        for (size_t v = 0; v < vertexCount; v++)
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        adjacency.resize(current.size());
+        std::vector<GLuint> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < current.size(); i++)
+            adjacency[fill[current[i]]++] = (GLuint)(i / 3);
+
+        // every edge, collapsed the cheaper way
+        collapses.clear();
+        for (size_t i = 0; i < current.size(); i += 3) {
+            for (int e = 0; e < 3; e++) {
+                GLuint a = current[i + e], b = current[i + (e + 1) % 3];
+                Quadric q = quadrics[a];
+                q.Add(quadrics[b]);
+                float toB = locked[a] ? INFINITY : q.Error(Position(positions, vertexStride, b));
+                float toA = locked[b] ? INFINITY : q.Error(Position(positions, vertexStride, a));
+                if (toB <= toA && toB != INFINITY)
+                    collapses.push_back({ a, b, toB });
+                else if (toA < toB)
+                    collapses.push_back({ b, a, toA });
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), 
+            [](const Collapse& l, const Collapse& r) { return l.Error < r.Error; });
+
+        for (GLuint v = 0; v < vertexCount; v++)
+            remap[v] = v;
+        std::fill(touched.begin(), touched.end(), false);
+
+        size_t removed = 0, toRemove = triangleCount - targetIndexCount / 3;
+        for (const Collapse& collapse : collapses) {
+            if (collapse.Error > targetError || removed >= toRemove)
+                break;
+            if (touched[collapse.From] || touched[collapse.To])
+                continue;
+
+            // the triangles around From, with From moved onto To, must keep facing the same way
+            const float* target = Position(positions, vertexStride, collapse.To);
+            bool valid = true;
+            size_t degenerate = 0;
+            for (GLuint t = adjacencyOffsets[collapse.From]; t < adjacencyOffsets[collapse.From + 1] && valid; t++) {
+                const GLuint* triangle = &current[adjacency[t] * 3];
+                if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To) {
+                    degenerate++;
+                    continue;
+                }
+                const float* before[3];
+                const float* after[3];
+                for (int k = 0; k < 3; k++) {
+                    before[k] = Position(positions, vertexStride, triangle[k]);
+                    after[k] = triangle[k] == collapse.From ? target : before[k];
+                }
+                float n0[3], n1[3];
+                Normal(before[0], before[1], before[2], n0);
+                Normal(after[0], after[1], after[2], n1);
+                valid = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] > 0.0f;
+            }
+            if (!valid)
+                continue;
+
+            remap[collapse.From] = collapse.To;
+            quadrics[collapse.To].Add(quadrics[collapse.From]);
+            // the neighbourhood changed, its flip checks are stale until the next pass
+            for (GLuint t = adjacencyOffsets[collapse.From]; t < adjacencyOffsets[collapse.From + 1]; t++) {
+                for (int k = 0; k < 3; k++)
+                    touched[current[adjacency[t] * 3 + k]] = true;
+            }
+            removed += degenerate;
+            error = std::max(error, collapse.Error);
+        }
+        if (removed == 0)
+            break;
+
+        size_t write = 0;
+        for (size_t i = 0; i < current.size(); i += 3) {
+            GLuint a = remap[current[i]], b = remap[current[i + 1]], c = remap[current[i + 2]];
+            if (a == b || b == c || a == c)
+                continue;
+            current[write++] = a;
+            current[write++] = b;
+            current[write++] = c;
+        }
+        current.resize(write);
+    }
+
+    std::copy(current.begin(), current.end(), destination);
+    if (resultError)
+        *resultError = error;
+    return current.size();
+}
+
+std::vector<MeshFileLod> GenerateLods(std::vector<GLuint>& indices, const float* positions, 
+    size_t vertexCount, size_t vertexStride, unsigned int maxLods, float ratio, float maxError) {
+
+    std::vector<MeshFileLod> lods;
+    lods.push_back({ 0, (uint32_t)indices.size(), 0.0f, 0 });
+
+    std::vector<GLuint> simplified, optimized;
+    while (lods.size() < maxLods) {
+        const MeshFileLod& previous = lods.back();
+        simplified.resize(previous.IndexCount);
+        size_t target = (size_t)(previous.IndexCount / 3 * ratio) * 3;
+
+        float error = 0.0f;
+        size_t count = SimplifyMesh(simplified.data(), &indices[previous.FirstIndex], previous.IndexCount, 
+            positions, vertexCount, vertexStride, target, maxError - previous.Error, &error);
+        if (count == 0 || count > previous.IndexCount * 9 / 10)
+            break;
+
+        optimized.resize(count);
+        OptimizeVertexCache(optimized.data(), simplified.data(), count, vertexCount);
+
+        // the errors of the steps add up at worst
+        MeshFileLod lod = { (uint32_t)indices.size(), (uint32_t)count, previous.Error + error, 0 };
+        indices.insert(indices.end(), optimized.begin(), optimized.end());
+        lods.push_back(lod);
+    }
+    return lods;
+}
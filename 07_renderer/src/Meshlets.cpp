@@ -0,0 +1,194 @@
+#include "Meshlets.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "IndexData.h"
+#include "Parallel.h"
+
+
+// meshlets culled by one task
+static const size_t CULL_BLOCK = 256;
+
+static const float* Position(const float* positions, size_t stride, GLuint vertex) {
+    return (const float*)((const char*)positions + vertex * stride);
+}
+
+static float Dot(const float a[3], const float b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static void ComputeBounds(Meshlet& meshlet, const GLuint* indices, const float* positions, 
+    size_t stride) {
+
+    const GLuint* triangles = indices + meshlet.FirstIndex;
+    size_t indexCount = meshlet.TriangleCount * 3;
+
+    // sphere around the AABB center
+    float min[3] = { INFINITY, INFINITY, INFINITY }, max[3] = { -INFINITY, -INFINITY, -INFINITY };
+    for (size_t i = 0; i < indexCount; i++) {
+        const float* p = Position(positions, stride, triangles[i]);
+        for (int axis = 0; axis < 3; axis++) {
+            min[axis] = std::min(min[axis], p[axis]);
+            max[axis] = std::max(max[axis], p[axis]);
+        }
+    }
+    float radius2 = 0.0f;
+    for (int axis = 0; axis < 3; axis++)
+        meshlet.Center[axis] = (min[axis] + max[axis]) * 0.5f;
+    for (size_t i = 0; i < indexCount; i++) {
+        const float* p = Position(positions, stride, triangles[i]);
+        float d[3] = { p[0] - meshlet.Center[0], p[1] - meshlet.Center[1], p[2] - meshlet.Center[2] };
+        radius2 = std::max(radius2, Dot(d, d));
+    }
+    meshlet.Radius = std::sqrt(radius2);
+
+    // cone axis: the average of the triangle normals
+    float normals[MESHLET_MAX_TRIANGLES][3];
+    float axis[3] = { 0.0f, 0.0f, 0.0f };
+    for (size_t t = 0; t < meshlet.TriangleCount; t++) {
+        const float* a = Position(positions, stride, triangles[t * 3]);
+        const float* b = Position(positions, stride, triangles[t * 3 + 1]);
+        const float* c = Position(positions, stride, triangles[t * 3 + 2]);
+        float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        float* n = normals[t];
+        n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+        float length = std::sqrt(Dot(n, n));
+        float scale = length > 0.0f ? 1.0f / length : 0.0f;  // degenerate ones stay 0
+        for (int k = 0; k < 3; k++) {
+            n[k] *= scale;
+            axis[k] += n[k];
+        }
+    }
+
+    float axisLength = std::sqrt(Dot(axis, axis));
+    meshlet.ConeCutoff = 2.0f;
+    memcpy(meshlet.ConeApex, meshlet.Center, sizeof(meshlet.ConeApex));
+    meshlet.ConeAxis[0] = meshlet.ConeAxis[1] = meshlet.ConeAxis[2] = 0.0f;
+    if (axisLength == 0.0f)
+        return;
+    for (int k = 0; k < 3; k++)
+        meshlet.ConeAxis[k] = axis[k] / axisLength;
+
+    // the widest normal gives the cone angle, past ~85 degrees it's useless
+    float minDot = 1.0f;
+    for (size_t t = 0; t < meshlet.TriangleCount; t++) {
+        if (Dot(normals[t], normals[t]) > 0.0f)
+            minDot = std::min(minDot, Dot(normals[t], meshlet.ConeAxis));
+    }
+    if (minDot <= 0.1f)
+        return;
+
+    // apex: far enough back along the axis to be behind every triangle plane
+    float maxT = 0.0f;
+    for (size_t t = 0; t < meshlet.TriangleCount; t++) {
+        if (Dot(normals[t], normals[t]) == 0.0f)
+            continue;
+        const float* a = Position(positions, stride, triangles[t * 3]);
+        float toCenter[3] = { meshlet.Center[0] - a[0], meshlet.Center[1] - a[1], meshlet.Center[2] - a[2] };
+        maxT = std::max(maxT, Dot(toCenter, normals[t]) / Dot(meshlet.ConeAxis, normals[t]));
+    }
+    for (int k = 0; k < 3; k++)
+        meshlet.ConeApex[k] = meshlet.Center[k] - meshlet.ConeAxis[k] * maxT;
+    meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+std::vector<Meshlet> BuildMeshlets(const GLuint* indices, size_t indexCount, const float* positions, 
+    size_t vertexCount, size_t vertexStride, unsigned int maxVertices, unsigned int maxTriangles) {
+
+    ASSERT(maxVertices >= 3 && maxTriangles <= MESHLET_MAX_TRIANGLES);
+    std::vector<Meshlet> meshlets;
+    // which meshlet last used a vertex, + 1
+    std::vector<uint32_t> owner(vertexCount, 0);
+
+    Meshlet current = {};
+    for (size_t i = 0; i < indexCount; i += 3) {
+        uint32_t id = (uint32_t)meshlets.size() + 1;
+        GLuint a = indices[i], b = indices[i + 1], c = indices[i + 2];
+        unsigned int added = (owner[a] != id) + (b != a && owner[b] != id) + 
+            (c != a && c != b && owner[c] != id);
+
+        if (current.TriangleCount == maxTriangles || current.VertexCount + added > maxVertices) {
+            meshlets.push_back(current);
+            current = {};
+            current.FirstIndex = (uint32_t)i;
+            id++;
+        }
+        for (int k = 0; k < 3; k++) {
+            if (owner[indices[i + k]] != id) {
+                owner[indices[i + k]] = id;
+                current.VertexCount++;
+            }
+        }
+        current.TriangleCount++;
+    }
+    if (current.TriangleCount)
+        meshlets.push_back(current);
+
+    ParallelFor(meshlets.size(), [&](size_t m) {
+        ComputeBounds(meshlets[m], indices, positions, vertexStride);
+    });
+    return meshlets;
+}
+
+size_t CullMeshlets(const std::vector<Meshlet>& meshlets, const Frustum& frustum, 
+    const float cameraPosition[3], std::vector<uint32_t>& visible, unsigned int maxThreads) {
+
+    // every block fills its own slice, then the slices are packed
+    size_t blocks = (meshlets.size() + CULL_BLOCK - 1) / CULL_BLOCK;
+    visible.resize(meshlets.size());
+    std::vector<uint32_t> counts(blocks);
+
+    ParallelFor(blocks, [&](size_t block) {
+        size_t begin = block * CULL_BLOCK, end = std::min(begin + CULL_BLOCK, meshlets.size());
+        uint32_t* out = &visible[begin];
+        uint32_t count = 0;
+        for (size_t m = begin; m < end; m++) {
+            const Meshlet& meshlet = meshlets[m];
+            if (!frustum.TestSphere(meshlet.Center, meshlet.Radius))
+                continue;
+
+            float view[3] = { meshlet.ConeApex[0] - cameraPosition[0], meshlet.ConeApex[1] - cameraPosition[1], 
+                meshlet.ConeApex[2] - cameraPosition[2] };
+            float length = std::sqrt(Dot(view, view));
+            if (Dot(view, meshlet.ConeAxis) >= meshlet.ConeCutoff * length)
+                continue;
+
+            out[count++] = (uint32_t)m;
+        }
+        counts[block] = count;
+    }, maxThreads);
+
+    size_t total = 0;
+    for (size_t block = 0; block < blocks; block++) {
+        if (total != block * CULL_BLOCK)
+            memmove(&visible[total], &visible[block * CULL_BLOCK], counts[block] * sizeof(uint32_t));
+        total += counts[block];
+    }
+    visible.resize(total);
+    return total;
+}
+
+uint32_t AddMeshletDraws(DrawCommandBuilder& builder, const std::vector<Meshlet>& meshlets, 
+    const std::vector<uint32_t>& visible, GLenum indexType, GLintptr indexOffset, GLint baseVertex) {
+
+    GLsizei indexSize = GetIndexSize(indexType);
+    uint32_t commands = 0;
+    for (size_t i = 0; i < visible.size();) {
+        const Meshlet& first = meshlets[visible[i]];
+        uint32_t count = first.TriangleCount * 3;
+        // merge while the next visible meshlet starts where this run ends
+        size_t j = i + 1;
+        for (; j < visible.size() && meshlets[visible[j]].FirstIndex == first.FirstIndex + count; j++)
+            count += meshlets[visible[j]].TriangleCount * 3;
+
+        builder.Add(count, indexType, indexOffset + (GLintptr)first.FirstIndex * indexSize, baseVertex);
+        commands++;
+        i = j;
+    }
+    return commands;
+}
@@ -0,0 +1,340 @@
+#include "ObjLoader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+#include "MappedFile.h"
+#include "Parallel.h"
+
+
+// chunks per thread, so a chunk full of faces does not hold up the others
+static const size_t CHUNKS_PER_THREAD = 4;
+static const int32_t MISSING = INT32_MIN;
+
+// Corner::Relative bits
+static const uint8_t RELATIVE_V = 1, RELATIVE_T = 2, RELATIVE_N = 4;
+
+/**
+ * @brief a face corner: 0 based indices. Negative OBJ indices are stored 
+ * relative to the first attribute of the chunk (flagged in Relative), they 
+ * are resolved once the chunk offsets are known.
+ */
+struct Corner {
+    int32_t V, T, N;
+    uint8_t Relative;
+};
+
+struct Chunk {
+    const char* Begin;
+    const char* End;
+    std::vector<float> Positions, TexCoords, Normals;
+    std::vector<Corner> Corners;    // 3 per triangle
+    bool Failed;
+};
+
+static inline const char* SkipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+    return p;
+}
+
+static inline const char* NextLine(const char* p, const char* end) {
+    const char* newline = (const char*)memchr(p, '\n', end - p);
+    return newline ? newline + 1 : end;
+}
+
+static inline const char* ParseFloats(const char* p, const char* end, float* out, int count) {
+    for (int i = 0; i < count; i++) {
+        p = SkipSpaces(p, end);
+        if (p < end && *p == '+')
+            p++;
+        std::from_chars_result result = std::from_chars(p, end, out[i]);
+        if (result.ec != std::errc())
+            return nullptr;
+        p = result.ptr;
+    }
+    return p;
+}
+
+/**
+ * @brief 1 based / negative OBJ index to a 0 based one, sets flag in 
+ * relative for negative ones
+ */
+static inline int32_t ResolveIndex(int32_t index, size_t localCount, uint8_t flag, uint8_t& relative) {
+    if (index > 0)
+        return index - 1;
+    if (index < 0) {
+        relative |= flag;
+        return (int32_t)localCount + index;
+    }
+    return MISSING; // 0 is not a valid OBJ index
+}
+
+static void ParseChunk(Chunk& chunk) {
+    const char* p = chunk.Begin;
+    const char* end = chunk.End;
+    chunk.Failed = false;
+
+    std::vector<Corner> polygon;
+    while (p < end) {
+        p = SkipSpaces(p, end);
+        const char* line = p;
+        p = NextLine(p, end);
+        if (line + 1 >= end)
+            continue;
+
+        if (line[0] == 'v' && (line[1] == ' ' || line[1] == '\t')) {
+            float v[3];
+            if (!ParseFloats(line + 1, end, v, 3)) {
+                chunk.Failed = true;
+                return;
+            }
+            chunk.Positions.insert(chunk.Positions.end(), v, v + 3);
+        } else if (line[0] == 'v' && line[1] == 't') {
+            float v[2];
+            if (!ParseFloats(line + 2, end, v, 2)) {
+                chunk.Failed = true;
+                return;
+            }
+            chunk.TexCoords.insert(chunk.TexCoords.end(), v, v + 2);
+        } else if (line[0] == 'v' && line[1] == 'n') {
+            float v[3];
+            if (!ParseFloats(line + 2, end, v, 3)) {
+                chunk.Failed = true;
+                return;
+            }
+            chunk.Normals.insert(chunk.Normals.end(), v, v + 3);
+        } else if (line[0] == 'f' && (line[1] == ' ' || line[1] == '\t')) {
+            polygon.clear();
+            const char* q = line + 1;
+            const char* lineEnd = p;
+            for (;;) {
+                q = SkipSpaces(q, lineEnd);
+                if (q >= lineEnd || *q == '\n' || *q == '\r' || *q == '#')
+                    break;
+
+                // v, v/vt, v//vn or v/vt/vn
+                int32_t values[3] = {0, 0, 0};
+                for (int k = 0; k < 3; k++) {
+                    if (k > 0) {
+                        if (q >= lineEnd || *q != '/')
+                            break;
+                        q++;
+                    }
+                    std::from_chars_result result = std::from_chars(q, lineEnd, values[k]);
+                    if (result.ec == std::errc())
+                        q = result.ptr;
+                }
+                if (values[0] == 0) {
+                    chunk.Failed = true;
+                    return;
+                }
+                Corner corner;
+                corner.Relative = 0;
+                corner.V = ResolveIndex(values[0], chunk.Positions.size() / 3, RELATIVE_V, corner.Relative);
+                corner.T = ResolveIndex(values[1], chunk.TexCoords.size() / 2, RELATIVE_T, corner.Relative);
+                corner.N = ResolveIndex(values[2], chunk.Normals.size() / 3, RELATIVE_N, corner.Relative);
+                polygon.push_back(corner);
+                while (q < lineEnd && *q != ' ' && *q != '\t' && *q != '\r' && *q != '\n')
+                    q++;
+            }
+
+            // fan triangulation
+            for (size_t i = 2; i < polygon.size(); i++) {
+                chunk.Corners.push_back(polygon[0]);
+                chunk.Corners.push_back(polygon[i - 1]);
+                chunk.Corners.push_back(polygon[i]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief open addressing (linear probing) map from a resolved v/vt/vn 
+ * triplet to the output vertex
+ */
+class VertexMap {
+public:
+    VertexMap(size_t expected) {
+        size_t capacity = 16;
+        while (capacity < expected * 2)
+            capacity <<= 1;
+        m_Mask = capacity - 1;
+        m_Slots.resize(capacity, {{0, 0, 0, 0}, EMPTY});
+    }
+
+    // returns the vertex of the triplet, inserting next if it's new
+    uint32_t Insert(const Corner& key, uint32_t next, bool& inserted) {
+        size_t slot = Hash(key) & m_Mask;
+        for (;;) {
+            Slot& s = m_Slots[slot];
+            if (s.Value == EMPTY) {
+                s.Key = key;
+                s.Value = next;
+                inserted = true;
+                return next;
+            }
+            if (s.Key.V == key.V && s.Key.T == key.T && s.Key.N == key.N) {
+                inserted = false;
+                return s.Value;
+            }
+            slot = (slot + 1) & m_Mask;
+        }
+    }
+
+private:
+    static const uint32_t EMPTY = 0xFFFFFFFF;
+    struct Slot {
+        Corner Key;
+        uint32_t Value;
+    };
+
+    static size_t Hash(const Corner& key) {
+        uint64_t h = (uint32_t)key.V * 0x9E3779B97F4A7C15ull;
+        h ^= ((uint32_t)key.T + 0x7F4A7C15ull) * 0xC2B2AE3D27D4EB4Full;
+        h ^= ((uint32_t)key.N + 0x165667B1ull) * 0x165667B19E3779F9ull;
+        return (size_t)(h ^ (h >> 29));
+    }
+
+    std::vector<Slot> m_Slots;
+    size_t m_Mask;
+};
+
+bool LoadObj(const std::string& filePath, ObjMesh& mesh, unsigned int maxThreads) {
+    MappedFile file;
+    if (!file.Open(filePath))
+        return false;
+
+    const char* data = file.GetData();
+    const char* end = data + file.GetSize();
+    unsigned int threads = maxThreads ? maxThreads : GetWorkerCount();
+
+    // 1. split at line boundaries
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threads * CHUNKS_PER_THREAD, 
+        file.GetSize() / 4096 + 1));
+    std::vector<Chunk> chunks(chunkCount);
+    const char* begin = data;
+    for (size_t c = 0; c < chunkCount; c++) {
+        const char* split = c + 1 == chunkCount ? end : data + file.GetSize() * (c + 1) / chunkCount;
+        if (split < begin)
+            split = begin;
+        split = split < end ? NextLine(split, end) : end;
+        chunks[c].Begin = begin;
+        chunks[c].End = split;
+        begin = split;
+    }
+
+    // 2. parse every chunk on its own
+    ParallelFor(chunkCount, [&](size_t c) { ParseChunk(chunks[c]); }, threads);
+
+    // 3. where the attributes of every chunk land in the merged arrays
+    std::vector<size_t> positionBase(chunkCount), texCoordBase(chunkCount), normalBase(chunkCount), 
+        cornerBase(chunkCount);
+    size_t positions = 0, texCoords = 0, normals = 0, corners = 0;
+    for (size_t c = 0; c < chunkCount; c++) {
+        if (chunks[c].Failed) {
+            std::cout << "Failed to parse " << filePath << std::endl;
+            return false;
+        }
+        positionBase[c] = positions;
+        texCoordBase[c] = texCoords;
+        normalBase[c] = normals;
+        cornerBase[c] = corners;
+        positions += chunks[c].Positions.size() / 3;
+        texCoords += chunks[c].TexCoords.size() / 2;
+        normals += chunks[c].Normals.size() / 3;
+        corners += chunks[c].Corners.size();
+    }
+
+    std::vector<float> allPositions(positions * 3), allTexCoords(texCoords * 2), allNormals(normals * 3);
+    std::vector<Corner> allCorners(corners);
+    std::atomic<bool> valid(true);
+    ParallelFor(chunkCount, [&](size_t c) {
+        Chunk& chunk = chunks[c];
+        std::copy(chunk.Positions.begin(), chunk.Positions.end(), allPositions.begin() + positionBase[c] * 3);
+        std::copy(chunk.TexCoords.begin(), chunk.TexCoords.end(), allTexCoords.begin() + texCoordBase[c] * 2);
+        std::copy(chunk.Normals.begin(), chunk.Normals.end(), allNormals.begin() + normalBase[c] * 3);
+
+        // relative indices become absolute, everything is range checked
+        for (size_t i = 0; i < chunk.Corners.size(); i++) {
+            Corner corner = chunk.Corners[i];
+            if (corner.Relative & RELATIVE_V)
+                corner.V += (int32_t)positionBase[c];
+            if (corner.Relative & RELATIVE_T)
+                corner.T += (int32_t)texCoordBase[c];
+            if (corner.Relative & RELATIVE_N)
+                corner.N += (int32_t)normalBase[c];
+            corner.Relative = 0;
+
+            if (corner.V < 0 || (size_t)corner.V >= positions || 
+                (corner.T != MISSING && (corner.T < 0 || (size_t)corner.T >= texCoords)) || 
+                (corner.N != MISSING && (corner.N < 0 || (size_t)corner.N >= normals)))
+                valid = false;
+            allCorners[cornerBase[c] + i] = corner;
+        }
+        chunk = Chunk(); // release the chunk memory early
+    }, threads);
+
+    if (!valid) {
+        std::cout << "Index out of range in " << filePath << std::endl;
+        return false;
+    }
+
+    // 4. deduplicate the triplets
+    mesh.HasTexCoords = texCoords > 0;
+    mesh.HasNormals = normals > 0;
+    mesh.Indices.resize(corners);
+
+    // flat shaded or UV seamed models have about as many vertices as 
+    // corners: size for that, the map stays at most half full
+    VertexMap map(corners);
+    std::vector<Corner> unique;
+    unique.reserve(corners);
+    for (size_t i = 0; i < corners; i++) {
+        bool inserted;
+        mesh.Indices[i] = map.Insert(allCorners[i], (uint32_t)unique.size(), inserted);
+        if (inserted)
+            unique.push_back(allCorners[i]);
+    }
+    mesh.VertexCount = (uint32_t)unique.size();
+
+    // 5. gather the interleaved vertices
+    mesh.Layout = VertexBufferLayout();
+    mesh.Layout.Push(GL_FLOAT, 3);
+    if (mesh.HasNormals)
+        mesh.Layout.Push(GL_FLOAT, 3);
+    if (mesh.HasTexCoords)
+        mesh.Layout.Push(GL_FLOAT, 2);
+    size_t floats = mesh.Layout.GetStride() / sizeof(float);
+
+    mesh.Vertices.resize(unique.size() * floats);
+    const size_t block = 65536;
+    ParallelFor((unique.size() + block - 1) / block, [&](size_t b) {
+        size_t last = std::min(unique.size(), (b + 1) * block);
+        for (size_t v = b * block; v < last; v++) {
+            const Corner& corner = unique[v];
+            float* out = &mesh.Vertices[v * floats];
+            memcpy(out, &allPositions[(size_t)corner.V * 3], 3 * sizeof(float));
+            out += 3;
+            if (mesh.HasNormals) {
+                if (corner.N != MISSING)
+                    memcpy(out, &allNormals[(size_t)corner.N * 3], 3 * sizeof(float));
+                else
+                    out[0] = out[1] = out[2] = 0.0f;
+                out += 3;
+            }
+            if (mesh.HasTexCoords) {
+                if (corner.T != MISSING)
+                    memcpy(out, &allTexCoords[(size_t)corner.T * 2], 2 * sizeof(float));
+                else
+                    out[0] = out[1] = 0.0f;
+            }
+        }
+    }, threads);
+
+    return true;
+}
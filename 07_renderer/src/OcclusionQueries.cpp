@@ -0,0 +1,71 @@
+#include "OcclusionQueries.h"
+
+
+OcclusionQueries::OcclusionQueries(uint32_t maxObjects, uint32_t framesInFlight) 
+    : m_MaxObjects(maxObjects), m_Frames(framesInFlight), m_Slot(0), m_Current(0), 
+    m_Queries((size_t)maxObjects * framesInFlight), m_Pending((size_t)maxObjects * framesInFlight, 0), 
+    m_Visible(maxObjects, true) {
+
+    ASSERT(framesInFlight > 0);
+    m_Target = (GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility) ? GL_ANY_SAMPLES_PASSED_CONSERVATIVE 
+        : GL_ANY_SAMPLES_PASSED;
+    GLCall( glGenQueries((GLsizei)m_Queries.size(), m_Queries.data()) );
+}
+
+OcclusionQueries::~OcclusionQueries() {
+    glDeleteQueries((GLsizei)m_Queries.size(), m_Queries.data());
+}
+
+void OcclusionQueries::BeginFrame() {
+    m_Slot = (m_Slot + 1) % m_Frames;
+
+    // issued age frames ago, oldest first so a newer result wins
+    for (uint32_t age = m_Frames; age > 0; age--) {
+        uint32_t slot = (m_Slot + m_Frames - age) % m_Frames;
+        for (uint32_t object = 0; object < m_MaxObjects; object++) {
+            size_t index = (size_t)slot * m_MaxObjects + object;
+            if (!m_Pending[index])
+                continue;
+            GLuint available = GL_FALSE;
+            GLCall( glGetQueryObjectuiv(m_Queries[index], GL_QUERY_RESULT_AVAILABLE, &available) );
+            if (available) {
+                GLuint passed = GL_FALSE;
+                GLCall( glGetQueryObjectuiv(m_Queries[index], GL_QUERY_RESULT, &passed) );
+                m_Visible[object] = passed != GL_FALSE;
+                m_Pending[index] = 0;
+            } else if (slot == m_Slot) {
+                // too late, the query is reused now: keep the last answer
+                m_Pending[index] = 0;
+            }
+        }
+    }
+}
+
+void OcclusionQueries::BeginProxies() {
+    GLCall( glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE) );
+    GLCall( glDepthMask(GL_FALSE) );
+}
+
+void OcclusionQueries::EndProxies() {
+    GLCall( glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE) );
+    GLCall( glDepthMask(GL_TRUE) );
+}
+
+void OcclusionQueries::BeginQuery(uint32_t object) {
+    ASSERT(object < m_MaxObjects);
+    m_Current = object;
+    GLCall( glBeginQuery(m_Target, Query(m_Slot, object)) );
+}
+
+void OcclusionQueries::EndQuery() {
+    GLCall( glEndQuery(m_Target) );
+    m_Pending[(size_t)m_Slot * m_MaxObjects + m_Current] = 1;
+}
+
+void OcclusionQueries::BeginConditionalRender(uint32_t object) {
+    GLCall( glBeginConditionalRender(Query(m_Slot, object), GL_QUERY_NO_WAIT) );
+}
+
+void OcclusionQueries::EndConditionalRender() {
+    GLCall( glEndConditionalRender() );
+}
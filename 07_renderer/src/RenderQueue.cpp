@@ -0,0 +1,109 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+static const uint64_t DEPTH_MAX = (1u << 24) - 1;
+
+static uint64_t QuantizeDepth(float depth) {
+    return (uint64_t)(std::clamp(depth, 0.0f, 1.0f) * (float)DEPTH_MAX);
+}
+
+uint64_t DrawKey::Encode() const {
+    uint64_t key = (uint64_t)(Layer & 0xF) << 60;
+    uint64_t depth = QuantizeDepth(Depth);
+    uint64_t state = ((uint64_t)(Program & 0x3FF) << 22) | ((uint64_t)(Material & 0xFFF) << 10) | 
+        (uint64_t)(VAO & 0x3FF);
+
+    if (!Translucent)
+        return key | (state << 27) | (depth << 3);
+
+    return key | (1ull << 59) | ((DEPTH_MAX - depth) << 35) | (state << 3);
+}
+
+DrawKey DrawKey::Decode(uint64_t key) {
+    DrawKey draw;
+    draw.Layer = (uint8_t)(key >> 60);
+    draw.Translucent = (key >> 59) & 1;
+
+    uint64_t state, depth;
+    if (!draw.Translucent) {
+        state = (key >> 27) & 0xFFFFFFFF;
+        depth = (key >> 3) & DEPTH_MAX;
+    } else {
+        depth = DEPTH_MAX - ((key >> 35) & DEPTH_MAX);
+        state = (key >> 3) & 0xFFFFFFFF;
+    }
+    draw.Program = (uint16_t)((state >> 22) & 0x3FF);
+    draw.Material = (uint16_t)((state >> 10) & 0xFFF);
+    draw.VAO = (uint16_t)(state & 0x3FF);
+    draw.Depth = (float)depth / (float)DEPTH_MAX;
+    return draw;
+}
+
+void RenderQueue::RadixSort(Item* items, Item* scratch, size_t count) {
+    if (count == 0)
+        return;
+
+    // all 8 histograms in one read of the keys
+    static const int PASSES = 8;
+    std::vector<uint32_t> histograms(PASSES * 256, 0);
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = items[i].Key;
+        for (int pass = 0; pass < PASSES; pass++)
+            histograms[pass * 256 + ((key >> (pass * 8)) & 0xFF)]++;
+    }
+
+    Item* src = items;
+    Item* dst = scratch;
+    for (int pass = 0; pass < PASSES; pass++) {
+        uint32_t* histogram = &histograms[pass * 256];
+        int shift = pass * 8;
+
+        // every key has the same digit: nothing to do for this pass
+        if (histogram[(src[0].Key >> shift) & 0xFF] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            uint32_t n = histogram[digit];
+            histogram[digit] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; i++) {
+            const Item& item = src[i];
+            dst[histogram[(item.Key >> shift) & 0xFF]++] = item;
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != items)
+        memcpy(items, src, count * sizeof(Item));
+}
+
+void RenderQueue::Sort() {
+    if (m_Items.size() < 2)
+        return;
+    m_Scratch.resize(m_Items.size());
+    RadixSort(m_Items.data(), m_Scratch.data(), m_Items.size());
+}
+
+BindStats RenderQueue::CountBinds() const {
+    BindStats stats = {0, 0, 0};
+    bool first = true;
+    DrawKey last = {};
+
+    for (const Item& item : m_Items) {
+        DrawKey draw = DrawKey::Decode(item.Key);
+        if (first || draw.Program != last.Program)
+            stats.Programs++;
+        if (first || draw.Program != last.Program || draw.Material != last.Material)
+            stats.Materials++; // a new program needs its uniforms again
+        if (first || draw.VAO != last.VAO)
+            stats.VAOs++;
+        last = draw;
+        first = false;
+    }
+    return stats;
+}
@@ -0,0 +1,88 @@
+#include "Shader.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <alloca.h>
+
+
+ShaderProgramSource parseShader(const std::string& filePath) {
+    std::ifstream stream(filePath);
+
+    enum class ShaderType {
+        NONE = -1, VERTEX = 0, FRAGMENT = 1
+    };
+
+    std::stringstream ss[2];
+
+    // Check if the file is open, which indicates that it exists
+    if (stream.is_open()) {
+        std::cout << "File exists." << std::endl;
+        
+        std::string line;
+        ShaderType type = ShaderType::NONE;
+
+        while(getline(stream, line)) {
+            if (line.find("#shader") != std::string::npos) {
+                if (line.find("vertex") != std::string::npos) {
+                    type = ShaderType::VERTEX;
+                } else if (line.find("fragment") != std::string::npos) {
+                    type = ShaderType::FRAGMENT;
+                }
+            } else {
+                ss[(int)type] << line << "\n";
+            }
+        }
+
+        // Close the file after using it
+        stream.close();
+    } else {
+        std::cout << "File does not exist." << std::endl;
+    }
+
+    return {ss[0].str(), ss[1].str()};
+}
+
+GLuint CompileShader(GLuint type, const std::string& source) {
+    GLuint id = glCreateShader(type); 
+    const char* src = source.c_str();
+    glShaderSource(id, 1, &src, nullptr);
+    glCompileShader(id);
+
+    // check compile Errors
+    int result;
+    glGetShaderiv(id, GL_COMPILE_STATUS, &result);
+    if (result == GL_FALSE) {
+        int length;
+        glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
+        char* message = (char*)alloca(length * sizeof(char));
+        glGetShaderInfoLog(id, length, &length, message);
+        std::cout << "Failed to compile " << 
+            (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader!" << std::endl;
+        std::cout << message << std::endl;
+        glDeleteShader(id);
+
+        return 0;
+    }
+
+    return id;
+}
+
+GLuint CreateShader(const std::string& vertexShader, const std::string& fragmentShader) {
+
+    GLuint program = glCreateProgram(); 
+    GLuint vs = CompileShader(GL_VERTEX_SHADER, vertexShader); 
+    GLuint fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader); 
+
+    // now we attach the shaders to our program
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glLinkProgram(program);
+    glValidateProgram(program);
+
+    // clean up 
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    return program;
+}
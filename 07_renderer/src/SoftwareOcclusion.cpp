@@ -0,0 +1,224 @@
+#include "SoftwareOcclusion.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Debug.h"
+#include "Parallel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define OCCLUSION_SSE
+#include <immintrin.h>
+#endif
+
+
+/**
+ * @brief in front of the near plane (z < -w in clip space), what GL clips. 
+ * w <= 0 (behind the eye) is tested too, for matrices that aren't a plain 
+ * perspective
+ */
+static bool BeforeNearPlane(const Vec4& clip) {
+    return clip.Z < -clip.W || clip.W <= 0.0f;
+}
+
+SoftwareOcclusion::SoftwareOcclusion(uint32_t width, uint32_t height) 
+    : m_Width(width), m_Height(height), m_TilesX(width / TileWidth), m_TilesY(height / TileHeight), 
+    m_ViewProjection(), m_Bins((size_t)m_TilesX * m_TilesY) {
+
+    ASSERT(width % TileWidth == 0 && height % TileHeight == 0);
+    uint32_t w = width, h = height;
+    for (;;) {
+        m_Levels.emplace_back((size_t)w * h, 1.0f);
+        m_LevelWidth.push_back(w);
+        m_LevelHeight.push_back(h);
+        if (w == 1 && h == 1)
+            break;
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+}
+
+void SoftwareOcclusion::Begin(const float viewProjection[16]) {
+    std::copy(viewProjection, viewProjection + 16, m_ViewProjection.Values);
+    m_Triangles.clear();
+    for (std::vector<uint32_t>& bin : m_Bins)
+        bin.clear();
+}
+
+void SoftwareOcclusion::AddOccluder(const float* positions, size_t vertexStride, const uint32_t* indices, 
+    size_t indexCount, const float* model) {
+
+    Mat4 matrix = m_ViewProjection;
+    if (model) {
+        Mat4 modelMatrix;
+        std::copy(model, model + 16, modelMatrix.Values);
+        matrix = m_ViewProjection * modelMatrix;
+    }
+
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        Triangle triangle;
+        bool clipped = false;
+        for (int k = 0; k < 3 && !clipped; k++) {
+            const float* p = (const float*)((const char*)positions + indices[i + k] * vertexStride);
+            Vec4 clip = matrix * Vec4{ p[0], p[1], p[2], 1.0f };
+            clipped = BeforeNearPlane(clip);
+            float inverseW = 1.0f / clip.W;
+            triangle.X[k] = (clip.X * inverseW * 0.5f + 0.5f) * m_Width;
+            triangle.Y[k] = (clip.Y * inverseW * 0.5f + 0.5f) * m_Height;
+            triangle.Z[k] = clip.Z * inverseW * 0.5f + 0.5f;
+        }
+        if (clipped)
+            continue;
+
+        float area = (triangle.X[1] - triangle.X[0]) * (triangle.Y[2] - triangle.Y[0]) - 
+            (triangle.X[2] - triangle.X[0]) * (triangle.Y[1] - triangle.Y[0]);
+        if (area <= 0.0f)
+            continue;
+
+        float minX = std::min({ triangle.X[0], triangle.X[1], triangle.X[2] });
+        float maxX = std::max({ triangle.X[0], triangle.X[1], triangle.X[2] });
+        float minY = std::min({ triangle.Y[0], triangle.Y[1], triangle.Y[2] });
+        float maxY = std::max({ triangle.Y[0], triangle.Y[1], triangle.Y[2] });
+        if (maxX < 0.0f || maxY < 0.0f || minX >= m_Width || minY >= m_Height)
+            continue;
+
+        uint32_t index = (uint32_t)m_Triangles.size();
+        m_Triangles.push_back(triangle);
+        int tileX0 = std::max(0, (int)minX / (int)TileWidth), tileX1 = std::min((int)m_TilesX - 1, (int)maxX / (int)TileWidth);
+        int tileY0 = std::max(0, (int)minY / (int)TileHeight), tileY1 = std::min((int)m_TilesY - 1, (int)maxY / (int)TileHeight);
+        for (int ty = tileY0; ty <= tileY1; ty++) {
+            for (int tx = tileX0; tx <= tileX1; tx++)
+                m_Bins[ty * m_TilesX + tx].push_back(index);
+        }
+    }
+}
+
+void SoftwareOcclusion::RasterizeTile(uint32_t tile) {
+    float* depth = m_Levels[0].data();
+    int tileX = (int)(tile % m_TilesX * TileWidth), tileY = (int)(tile / m_TilesX * TileHeight);
+
+    for (int y = tileY; y < tileY + (int)TileHeight; y++)
+        std::fill(depth + (size_t)y * m_Width + tileX, depth + (size_t)y * m_Width + tileX + TileWidth, 1.0f);
+
+    for (uint32_t index : m_Bins[tile]) {
+        const Triangle& t = m_Triangles[index];
+
+        // edge i goes from vertex i to i + 1, positive on the inner side
+        float a[3], b[3], c[3];
+        for (int i = 0; i < 3; i++) {
+            int j = (i + 1) % 3;
+            a[i] = t.Y[i] - t.Y[j];
+            b[i] = t.X[j] - t.X[i];
+            c[i] = -(a[i] * t.X[i] + b[i] * t.Y[i]);
+        }
+        // depth plane z = zx * x + zy * y + z0
+        float area = (t.X[1] - t.X[0]) * (t.Y[2] - t.Y[0]) - (t.X[2] - t.X[0]) * (t.Y[1] - t.Y[0]);
+        float zx = ((t.Z[1] - t.Z[0]) * (t.Y[2] - t.Y[0]) - (t.Z[2] - t.Z[0]) * (t.Y[1] - t.Y[0])) / area;
+        float zy = ((t.Z[2] - t.Z[0]) * (t.X[1] - t.X[0]) - (t.Z[1] - t.Z[0]) * (t.X[2] - t.X[0])) / area;
+        float z0 = t.Z[0] - zx * t.X[0] - zy * t.Y[0];
+
+        int minX = std::max(tileX, (int)std::floor(std::min({ t.X[0], t.X[1], t.X[2] })));
+        int maxX = std::min(tileX + (int)TileWidth - 1, (int)std::ceil(std::max({ t.X[0], t.X[1], t.X[2] })));
+        int minY = std::max(tileY, (int)std::floor(std::min({ t.Y[0], t.Y[1], t.Y[2] })));
+        int maxY = std::min(tileY + (int)TileHeight - 1, (int)std::ceil(std::max({ t.Y[0], t.Y[1], t.Y[2] })));
+        // 4 pixels at a time, the tile width is a multiple of 4
+        minX &= ~3;
+
+        for (int y = minY; y <= maxY; y++) {
+            float py = y + 0.5f;
+            float* row = depth + (size_t)y * m_Width;
+#ifdef OCCLUSION_SSE
+            __m128 rowE0 = _mm_set1_ps(b[0] * py + c[0]), rowE1 = _mm_set1_ps(b[1] * py + c[1]);
+            __m128 rowE2 = _mm_set1_ps(b[2] * py + c[2]), rowZ = _mm_set1_ps(zy * py + z0);
+            __m128 a0 = _mm_set1_ps(a[0]), a1 = _mm_set1_ps(a[1]), a2 = _mm_set1_ps(a[2]), az = _mm_set1_ps(zx);
+            const __m128 zero = _mm_setzero_ps();
+            for (int x = minX; x <= maxX; x += 4) {
+                __m128 px = _mm_add_ps(_mm_set1_ps((float)x), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+                __m128 inside = _mm_and_ps(_mm_and_ps(
+                    _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(a0, px), rowE0), zero), 
+                    _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(a1, px), rowE1), zero)), 
+                    _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(a2, px), rowE2), zero));
+                __m128 z = _mm_add_ps(_mm_mul_ps(az, px), rowZ);
+                __m128 old = _mm_loadu_ps(row + x);
+                __m128 nearest = _mm_min_ps(old, z);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, old)));
+            }
+#else
+            for (int x = minX; x <= maxX; x++) {
+                float px = x + 0.5f;
+                bool inside = a[0] * px + b[0] * py + c[0] > 0.0f && a[1] * px + b[1] * py + c[1] > 0.0f && 
+                    a[2] * px + b[2] * py + c[2] > 0.0f;
+                if (inside)
+                    row[x] = std::min(row[x], zx * px + zy * py + z0);
+            }
+#endif
+        }
+    }
+}
+
+void SoftwareOcclusion::Rasterize(unsigned int maxThreads) {
+    ParallelFor(m_Bins.size(), [this](size_t tile) { RasterizeTile((uint32_t)tile); }, maxThreads);
+
+    // each texel keeps the farthest depth of the 2x2 below it
+    for (size_t level = 1; level < m_Levels.size(); level++) {
+        const std::vector<float>& below = m_Levels[level - 1];
+        uint32_t belowWidth = m_LevelWidth[level - 1], belowHeight = m_LevelHeight[level - 1];
+        std::vector<float>& current = m_Levels[level];
+        uint32_t width = m_LevelWidth[level];
+        ParallelFor(m_LevelHeight[level], [&](size_t y) {
+            uint32_t y0 = (uint32_t)y * 2, y1 = std::min(y0 + 1, belowHeight - 1);
+            for (uint32_t x = 0; x < width; x++) {
+                uint32_t x0 = x * 2, x1 = std::min(x0 + 1, belowWidth - 1);
+                current[y * width + x] = std::max(
+                    std::max(below[y0 * belowWidth + x0], below[y0 * belowWidth + x1]), 
+                    std::max(below[y1 * belowWidth + x0], below[y1 * belowWidth + x1]));
+            }
+        }, level == 1 ? maxThreads : 1);
+    }
+}
+
+bool SoftwareOcclusion::IsVisible(const Aabb& bounds) const {
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY, minZ = INFINITY;
+    for (int corner = 0; corner < 8; corner++) {
+        float p[3] = { corner & 1 ? bounds.Max[0] : bounds.Min[0], corner & 2 ? bounds.Max[1] : bounds.Min[1], 
+            corner & 4 ? bounds.Max[2] : bounds.Min[2] };
+        Vec4 clip = m_ViewProjection * Vec4{ p[0], p[1], p[2], 1.0f };
+        // crossing the near plane, can't be hidden
+        if (BeforeNearPlane(clip))
+            return true;
+        float inverseW = 1.0f / clip.W;
+        minX = std::min(minX, clip.X * inverseW);
+        maxX = std::max(maxX, clip.X * inverseW);
+        minY = std::min(minY, clip.Y * inverseW);
+        maxY = std::max(maxY, clip.Y * inverseW);
+        minZ = std::min(minZ, clip.Z * inverseW);
+    }
+    if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f || minZ > 1.0f)
+        return false;
+
+    int x0 = std::max(0, (int)((minX * 0.5f + 0.5f) * m_Width));
+    int x1 = std::min((int)m_Width - 1, (int)((maxX * 0.5f + 0.5f) * m_Width));
+    int y0 = std::max(0, (int)((minY * 0.5f + 0.5f) * m_Height));
+    int y1 = std::min((int)m_Height - 1, (int)((maxY * 0.5f + 0.5f) * m_Height));
+    float nearest = minZ * 0.5f + 0.5f;
+
+    // up the pyramid until the rectangle is at most 4x4 texels
+    size_t level = 0;
+    while (level + 1 < m_Levels.size() && (x1 - x0 >= 4 || y1 - y0 >= 4)) {
+        x0 >>= 1;
+        x1 >>= 1;
+        y0 >>= 1;
+        y1 >>= 1;
+        level++;
+    }
+
+    const std::vector<float>& depth = m_Levels[level];
+    uint32_t width = m_LevelWidth[level];
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            if (nearest <= depth[y * width + x])
+                return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,133 @@
+#include "StreamBuffer.h"
+
+#include <iostream>
+
+
+StreamBuffer::StreamBuffer(GLsizeiptr bytesPerFrame, unsigned int framesInFlight)
+    : m_RendererID(0), m_Capacity(bytesPerFrame * framesInFlight), m_Mapped(nullptr),
+      m_Head(0), m_Tail(0), m_FrameStart(0) {
+
+    // GL_COPY_WRITE_BUFFER is never used for drawing, binding there does not 
+    // disturb the VAO (GL_ELEMENT_ARRAY_BUFFER) nor the GL_ARRAY_BUFFER state
+    GLCall( glGenBuffers(1, &m_RendererID) );
+    GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID) );
+
+    if (GLEW_ARB_buffer_storage) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLCall( glBufferStorage(GL_COPY_WRITE_BUFFER, m_Capacity, nullptr, flags) );
+        GLCall( m_Mapped = (char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, m_Capacity, flags) );
+        ASSERT(m_Mapped);
+    } else {
+        std::cout << "StreamBuffer: GL_ARB_buffer_storage not available, "
+            "using unsynchronized glMapBufferRange" << std::endl;
+        GLCall( glBufferData(GL_COPY_WRITE_BUFFER, m_Capacity, nullptr, GL_STREAM_DRAW) );
+    }
+
+    GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, 0) );
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (FrameFence& frame : m_Frames)
+        glDeleteSync(frame.Fence);
+
+    if (m_Mapped) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &m_RendererID);
+}
+
+StreamBuffer::Allocation StreamBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment) {
+    // a single allocation has to fit in the ring
+    uint64_t capacity = (uint64_t)m_Capacity;
+    ASSERT(size > 0 && (uint64_t)size <= capacity);
+
+    uint64_t position = m_Head % capacity;
+    uint64_t aligned = (position + alignment - 1) / alignment * alignment;
+    if (aligned + size > capacity)
+        aligned = capacity; // does not fit before the end: wrap to offset 0
+    uint64_t head = m_Head + (aligned - position);
+
+    // wait for the GPU until the region [head, head + size) is released
+    while (head + size - m_Tail > capacity) {
+        if (m_Frames.empty()) {
+            // this frame alone filled the ring: fence what has been drawn so 
+            // far and wait for it, a stall but still correct
+            std::cout << "StreamBuffer: a frame streamed more than " << m_Capacity 
+                << " bytes, stalling" << std::endl;
+            EndFrame();
+            if (m_Frames.empty()) {
+                m_Tail = head; // nothing left in flight, the whole ring is free
+                continue;
+            }
+        }
+        WaitForOldestFrame();
+    }
+
+    Allocation allocation;
+    allocation.Offset = (GLintptr)(head % capacity);
+    allocation.Size = size;
+    m_Head = head + size;
+
+    if (m_Mapped) {
+        allocation.Data = m_Mapped + allocation.Offset;
+    } else {
+        // the fences already guarantee the GPU is done with this range
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+        GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID) );
+        GLCall( allocation.Data = glMapBufferRange(GL_COPY_WRITE_BUFFER, allocation.Offset, size, flags) );
+        ASSERT(allocation.Data);
+    }
+
+    return allocation;
+}
+
+void StreamBuffer::Commit(const Allocation& allocation) {
+    (void)allocation;
+    if (m_Mapped)
+        return; // coherent mapping, nothing to flush
+
+    GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID) );
+    GLCall( glUnmapBuffer(GL_COPY_WRITE_BUFFER) );
+    GLCall( glBindBuffer(GL_COPY_WRITE_BUFFER, 0) );
+}
+
+void StreamBuffer::EndFrame() {
+    if (m_Head == m_FrameStart)
+        return; // nothing streamed this frame
+
+    GLsync fence;
+    GLCall( fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) );
+    m_Frames.push_back({fence, m_Head});
+    m_FrameStart = m_Head;
+
+    // release the frames the GPU already finished, without blocking
+    while (!m_Frames.empty()) {
+        GLenum result = glClientWaitSync(m_Frames.front().Fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+            break;
+        glDeleteSync(m_Frames.front().Fence);
+        m_Tail = m_Frames.front().End;
+        m_Frames.pop_front();
+    }
+}
+
+void StreamBuffer::WaitForOldestFrame() {
+    FrameFence frame = m_Frames.front();
+    m_Frames.pop_front();
+
+    // the first wait flushes the command queue so the fence is guaranteed 
+    // to be signaled eventually, then we keep waiting 1ms at a time
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    for (;;) {
+        GLenum result = glClientWaitSync(frame.Fence, flags, 1000000);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+            break;
+        ASSERT(result != GL_WAIT_FAILED);
+        flags = 0;
+    }
+    glDeleteSync(frame.Fence);
+
+    m_Tail = frame.End;
+}
@@ -0,0 +1,102 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Debug.h"
+#include "Parallel.h"
+
+
+// nodes per job inside a level
+static const size_t TRANSFORM_BLOCK = 1024;
+
+TransformHierarchy::Node TransformHierarchy::Add(const float local[16], Node parent) {
+    ASSERT(parent == None || parent < m_Position.size());
+    Node node = (Node)m_Position.size();
+    m_Position.push_back((uint32_t)m_Local.size());
+    m_Depth.push_back(parent == None ? 0 : m_Depth[parent] + 1);
+
+    Mat4 matrix;
+    memcpy(matrix.Values, local, sizeof(matrix.Values));
+    m_Local.push_back(matrix);
+    m_World.push_back(matrix);
+    m_Parent.push_back(parent == None ? (uint32_t)None : m_Position[parent]);
+    m_Node.push_back(node);
+    m_Dirty = true;
+    return node;
+}
+
+void TransformHierarchy::SetLocal(Node node, const float local[16]) {
+    memcpy(m_Local[m_Position[node]].Values, local, sizeof(Mat4::Values));
+}
+
+void TransformHierarchy::Clear() {
+    m_Local.clear();
+    m_World.clear();
+    m_Parent.clear();
+    m_Node.clear();
+    m_LevelStart.clear();
+    m_Position.clear();
+    m_Depth.clear();
+    m_Dirty = false;
+}
+
+void TransformHierarchy::Sort() {
+    // counting sort of the positions by depth, stable
+    uint32_t levels = *std::max_element(m_Depth.begin(), m_Depth.end()) + 1;
+    m_LevelStart.assign(levels + 1, 0);
+    for (uint32_t depth : m_Depth)
+        m_LevelStart[depth + 1]++;
+    for (uint32_t level = 0; level < levels; level++)
+        m_LevelStart[level + 1] += m_LevelStart[level];
+
+    std::vector<uint32_t> next(m_LevelStart.begin(), m_LevelStart.end() - 1);
+    std::vector<uint32_t> moved(m_Local.size());    // old position -> new
+    for (uint32_t position = 0; position < m_Local.size(); position++)
+        moved[position] = next[m_Depth[m_Node[position]]]++;
+
+    std::vector<Mat4> local(m_Local.size());
+    std::vector<uint32_t> parent(m_Local.size());
+    std::vector<Node> nodes(m_Local.size());
+    for (uint32_t position = 0; position < m_Local.size(); position++) {
+        uint32_t to = moved[position];
+        local[to] = m_Local[position];
+        parent[to] = m_Parent[position] == None ? (uint32_t)None : moved[m_Parent[position]];
+        nodes[to] = m_Node[position];
+        m_Position[m_Node[position]] = to;
+    }
+    m_Local.swap(local);
+    m_Parent.swap(parent);
+    m_Node.swap(nodes);
+    m_Dirty = false;
+}
+
+void TransformHierarchy::Update(unsigned int maxThreads) {
+    if (m_Local.empty())
+        return;
+    if (m_Dirty)
+        Sort();
+
+    // roots: world = local
+    memcpy(m_World.data(), m_Local.data(), m_LevelStart[1] * sizeof(Mat4));
+
+    for (size_t level = 1; level + 1 < m_LevelStart.size(); level++) {
+        size_t begin = m_LevelStart[level], end = m_LevelStart[level + 1];
+        size_t blocks = (end - begin + TRANSFORM_BLOCK - 1) / TRANSFORM_BLOCK;
+        ParallelFor(blocks, [&](size_t block) {
+            size_t first = begin + block * TRANSFORM_BLOCK, last = std::min(end, first + TRANSFORM_BLOCK);
+            for (size_t position = first; position < last; position++)
+                Multiply(m_World[position], m_World[m_Parent[position]], m_Local[position]);
+        }, maxThreads);
+    }
+}
+
+void TransformHierarchy::WriteInstances(const Node* nodes, size_t count, InstanceData* instances) const {
+    for (size_t i = 0; i < count; i++) {
+        const float* world = GetWorld(nodes[i]);
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 4; c++)
+                instances[i].Transform[r][c] = world[c * 4 + r];
+        }
+    }
+}
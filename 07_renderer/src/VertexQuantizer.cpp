@@ -0,0 +1,216 @@
+#include "VertexQuantizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (((bits >> 23) & 0xFF) == 0xFF) // inf / nan
+        return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+    if (exponent >= 31) // overflow -> inf
+        return sign | 0x7C00;
+
+    if (exponent <= 0) {
+        // denormal half (or zero)
+        if (exponent < -10)
+            return sign;
+        mantissa |= 0x800000;
+        uint32_t shift = (uint32_t)(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            half++;
+        return sign | (uint16_t)half;
+    }
+
+    uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++; // may carry into the exponent, which is still correct
+    return sign | (uint16_t)half;
+}
+
+float HalfToFloat(uint16_t half) {
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // renormalize the denormal
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+static bool IsSigned(GLenum type) {
+    return type == GL_BYTE || type == GL_SHORT || type == GL_INT_2_10_10_10_REV;
+}
+
+/**
+ * @brief value in [-1, 1] (or [0, 1]) to an integer with the given bits
+ */
+static int32_t ToNormalized(float value, bool isSigned, int bits) {
+    if (isSigned) {
+        float max = (float)((1 << (bits - 1)) - 1);
+        return (int32_t)std::lround(std::clamp(value, -1.0f, 1.0f) * max);
+    }
+    float max = (float)((1u << bits) - 1);
+    return (int32_t)std::lround(std::clamp(value, 0.0f, 1.0f) * max);
+}
+
+/**
+ * @brief bounds of one element, identity when the values already fit the 
+ * range of the target format
+ */
+static AttributeBounds ComputeBounds(const float* vertices, uint32_t count, GLsizei floatStride, 
+    GLsizei floatOffset, GLint components, const VertexBufferElement& target) {
+
+    AttributeBounds bounds;
+    for (int c = 0; c < 4; c++) {
+        bounds.Offset[c] = 0.0f;
+        bounds.Scale[c] = 1.0f;
+    }
+
+    bool integer = target.Type != GL_FLOAT && target.Type != GL_HALF_FLOAT;
+    if (!integer)
+        return bounds;
+    // integer formats are only meaningful normalized here
+    ASSERT(target.Normalized);
+
+    bool isSigned = IsSigned(target.Type);
+    for (int c = 0; c < components; c++) {
+        float lo = INFINITY, hi = -INFINITY;
+        for (uint32_t v = 0; v < count; v++) {
+            float value = vertices[v * floatStride + floatOffset + c];
+            lo = std::min(lo, value);
+            hi = std::max(hi, value);
+        }
+        if (count == 0 || (lo >= (isSigned ? -1.0f : 0.0f) && hi <= 1.0f))
+            continue;
+
+        float extent = hi - lo > 0.0f ? hi - lo : 1.0f;
+        if (isSigned) {
+            bounds.Offset[c] = (hi + lo) * 0.5f;
+            bounds.Scale[c] = extent * 0.5f;
+        } else {
+            bounds.Offset[c] = lo;
+            bounds.Scale[c] = extent;
+        }
+    }
+    return bounds;
+}
+
+QuantizedVertices QuantizeVertices(const float* vertices, uint32_t count, 
+    const VertexBufferLayout& source, const VertexBufferLayout& target) {
+
+    const std::vector<VertexBufferElement>& src = source.GetElements();
+    const std::vector<VertexBufferElement>& dst = target.GetElements();
+    ASSERT(src.size() == dst.size());
+
+    QuantizedVertices result;
+    result.Layout = target;
+    result.Data.resize((size_t)count * target.GetStride());
+
+    GLsizei floatStride = source.GetStride() / sizeof(float);
+    GLsizei floatOffset = 0;
+    GLsizei byteOffset = 0;
+
+    for (size_t e = 0; e < src.size(); e++) {
+        ASSERT(src[e].Type == GL_FLOAT && dst[e].Count >= src[e].Count);
+        GLint components = src[e].Count;
+
+        AttributeBounds bounds = ComputeBounds(vertices, count, floatStride, floatOffset, 
+            components, dst[e]);
+        result.Bounds.push_back(bounds);
+
+        bool isSigned = IsSigned(dst[e].Type);
+        for (uint32_t v = 0; v < count; v++) {
+            const float* in = vertices + v * floatStride + floatOffset;
+            uint8_t* out = result.Data.data() + (size_t)v * target.GetStride() + byteOffset;
+
+            float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            for (int c = 0; c < components; c++)
+                value[c] = (in[c] - bounds.Offset[c]) / bounds.Scale[c];
+
+            switch (dst[e].Type) {
+                case GL_FLOAT:
+                    memcpy(out, value, dst[e].Count * sizeof(float));
+                    break;
+                case GL_HALF_FLOAT:
+                    for (int c = 0; c < dst[e].Count; c++) {
+                        uint16_t half = FloatToHalf(value[c]);
+                        memcpy(out + c * 2, &half, 2);
+                    }
+                    break;
+                case GL_SHORT:
+                case GL_UNSIGNED_SHORT:
+                    for (int c = 0; c < dst[e].Count; c++) {
+                        uint16_t q = (uint16_t)ToNormalized(value[c], isSigned, 16);
+                        memcpy(out + c * 2, &q, 2);
+                    }
+                    break;
+                case GL_BYTE:
+                case GL_UNSIGNED_BYTE:
+                    for (int c = 0; c < dst[e].Count; c++)
+                        out[c] = (uint8_t)ToNormalized(value[c], isSigned, 8);
+                    break;
+                case GL_INT_2_10_10_10_REV: {
+                    ASSERT(dst[e].Count == 4);
+                    uint32_t packed = 
+                        ((uint32_t)ToNormalized(value[0], true, 10) & 0x3FF) |
+                        (((uint32_t)ToNormalized(value[1], true, 10) & 0x3FF) << 10) |
+                        (((uint32_t)ToNormalized(value[2], true, 10) & 0x3FF) << 20) |
+                        (((uint32_t)ToNormalized(value[3], true, 2) & 0x3) << 30);
+                    memcpy(out, &packed, 4);
+                    break;
+                }
+                default:
+                    ASSERT(false);
+            }
+        }
+
+        floatOffset += components;
+        byteOffset += dst[e].GetSize();
+    }
+
+    result.Report.SourceStride = source.GetStride();
+    result.Report.QuantizedStride = target.GetStride();
+    result.Report.SourceBytes = (size_t)count * source.GetStride();
+    result.Report.QuantizedBytes = result.Data.size();
+    return result;
+}
+
+void PrintQuantizationReport(const QuantizationReport& report) {
+    double saved = 100.0 * (1.0 - (double)report.QuantizedBytes / (double)report.SourceBytes);
+    std::cout << "[Quantization] " << report.SourceStride << " -> " << report.QuantizedStride 
+        << " bytes per vertex, " << report.SourceBytes << " -> " << report.QuantizedBytes 
+        << " bytes (" << saved << "% saved), vertex fetch bound draws up to " 
+        << (double)report.SourceStride / (double)report.QuantizedStride << "x faster" << std::endl;
+}
@@ -0,0 +1,80 @@
+/**
+ * Offline converter, OBJ -> .mesh (see MeshFile.h):
+ * 
+ *   ./renderer_meshconv input.obj output.mesh [--no-optimize] [--lods N]
+ * 
+ * The mesh goes through the same optimizer as at load (cache, overdraw and 
+ * fetch order) so the app only has to mmap and upload. With --lods, N - 1 
+ * simplified LODs are appended to the index stream (MeshSimplifier.h).
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjLoader.h"
+
+
+static double NowMilliseconds() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "usage: " << argv[0] << " input.obj output.mesh [--no-optimize] [--lods N]" << std::endl;
+        return 1;
+    }
+    std::string input = argv[1], output = argv[2];
+    bool optimize = true;
+    unsigned int lodCount = 1;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--no-optimize") == 0)
+            optimize = false;
+        else if (strcmp(argv[i], "--lods") == 0 && i + 1 < argc)
+            lodCount = (unsigned int)std::max(1, atoi(argv[++i]));
+    }
+
+    double start = NowMilliseconds();
+    ObjMesh mesh;
+    if (!LoadObj(input, mesh))
+        return 1;
+    std::cout << input << ": " << mesh.VertexCount << " vertices, " << mesh.Indices.size() / 3 
+        << " triangles (" << NowMilliseconds() - start << " ms)" << std::endl;
+
+    std::vector<uint8_t> vertices((const uint8_t*)mesh.Vertices.data(), 
+        (const uint8_t*)(mesh.Vertices.data() + mesh.Vertices.size()));
+    if (optimize) {
+        start = NowMilliseconds();
+        MeshOptimizationReport report = OptimizeMesh(vertices, mesh.Indices, mesh.Layout);
+        PrintMeshOptimizationReport(report);
+        std::cout << "optimized in " << NowMilliseconds() - start << " ms" << std::endl;
+    }
+
+    uint32_t vertexCount = (uint32_t)(vertices.size() / mesh.Layout.GetStride());
+    std::vector<MeshFileLod> lods;
+    if (lodCount > 1) {
+        start = NowMilliseconds();
+        lods = GenerateLods(mesh.Indices, (const float*)vertices.data(), vertexCount, 
+            mesh.Layout.GetStride(), lodCount);
+        for (size_t i = 0; i < lods.size(); i++)
+            std::cout << "LOD " << i << ": " << lods[i].IndexCount / 3 << " triangles, error " 
+                << lods[i].Error << std::endl;
+        std::cout << "simplified in " << NowMilliseconds() - start << " ms" << std::endl;
+    }
+
+    if (!WriteMeshFile(output, vertices.data(), vertexCount, mesh.Layout, mesh.Indices.data(), 
+        (uint32_t)mesh.Indices.size(), lods))
+        return 1;
+
+    std::cout << output << ": " << std::filesystem::file_size(output) << " bytes (obj: " 
+        << std::filesystem::file_size(input) << " bytes)" << std::endl;
+    return 0;
+}